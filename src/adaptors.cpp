@@ -23,11 +23,16 @@
 
 #include "adaptors.hpp"
 #include "wntrling.hpp"
+#include "metrics.hpp"
 #include <QtDBus/QDBusConnection>
+#include <QtDBus/QDBusMetaType>
 
 namespace Wintermute {
     namespace Linguistics {
         SystemAdaptor::SystemAdaptor() : Adaptor(Linguistics::System::instance()){
+            qDBusRegisterMetaType<QList<int> >();
+            qDBusRegisterMetaType<QList<QByteArray> >();
+            qDBusRegisterMetaType<QList<QList<QByteArray> > >();
             QDBusConnection::sessionBus().connect ("org.thesii.Wintermute","/Master",
                                       "org.thesii.Wintermute.Master","aboutToQuit",
                                       this,SLOT(quit()));
@@ -39,8 +44,85 @@ namespace Wintermute {
             CoreAdaptor::haltSystem ();
         }
 
-        void SystemAdaptor::tellSystem (const QString &p_txt) const {
-            Linguistics::System::tellSystem (p_txt);
+        qulonglong SystemAdaptor::tellSystem (const QString &p_txt) const {
+            return tellSystem (p_txt, QString(), Scheduler::Normal);
+        }
+
+        qulonglong SystemAdaptor::tellSystem (const QString &p_txt, const QString &p_lcl) const {
+            return tellSystem (p_txt, p_lcl, Scheduler::Normal);
+        }
+
+        qulonglong SystemAdaptor::tellSystem (const QString &p_txt, const QString &p_lcl, const int &p_prty) const {
+            return tellSystem (p_txt, p_lcl, p_prty, 0);
+        }
+
+        qulonglong SystemAdaptor::tellSystem (const QString &p_txt, const QString &p_lcl, const int &p_prty, const int &p_ddln) const {
+            Scheduler::Decision l_dcsn = Scheduler::Admitted;
+            const qulonglong l_rqst = Linguistics::System::tellSystem (p_txt, p_lcl, p_prty, p_ddln, client (), &l_dcsn);
+
+            if (l_rqst == 0)
+                reject (l_dcsn);
+
+            return l_rqst;
+        }
+
+        qulonglong SystemAdaptor::tellSystemBatch (const QStringList &p_txts, const QStringList &p_lcls, const QList<int> &p_prtys) const {
+            Scheduler::Decision l_dcsn = Scheduler::Admitted;
+            const qulonglong l_rqst = Linguistics::System::tellSystemBatch (p_txts, p_lcls, p_prtys, client (), &l_dcsn);
+
+            if (l_rqst == 0)
+                reject (l_dcsn);
+
+            return l_rqst;
+        }
+
+        bool SystemAdaptor::cancel (const qulonglong &p_rqst) const {
+            return Linguistics::System::cancel (p_rqst, client ());
+        }
+
+        QVariantMap SystemAdaptor::schedulerMetrics () const {
+            return Linguistics::System::scheduler ()->metrics ();
+        }
+
+        QVariantMap SystemAdaptor::cacheMetrics () const {
+            return Linguistics::System::resultCache ()->metrics ();
+        }
+
+        QVariantMap SystemAdaptor::latencyMetrics () const {
+            return Linguistics::Metrics::snapshot ();
+        }
+
+        bool SystemAdaptor::dumpLatencyMetrics (const QString &p_pth) const {
+            return Linguistics::Metrics::dump (p_pth);
+        }
+
+        void SystemAdaptor::invalidateResults () const {
+            Linguistics::System::invalidateResults ();
+        }
+
+        void SystemAdaptor::useSharedResults (const bool &p_enbl) const {
+            Linguistics::System::setSharedResults (client (), p_enbl);
+        }
+
+        bool SystemAdaptor::releaseResult (const qulonglong &p_rqst) const {
+            return Linguistics::System::releaseResult (p_rqst, client ());
+        }
+
+        const QString SystemAdaptor::client () const {
+            if (calledFromDBus ())
+                return message ().service ();
+
+            return "local";
+        }
+
+        void SystemAdaptor::reject (const int& p_dcsn) const {
+            if (!calledFromDBus ())
+                return;
+
+            const QString l_nm = (p_dcsn == Scheduler::RejectedClientLimit) ?
+                                     "org.thesii.Wintermute.Linguistics.Error.ClientLimit" :
+                                     "org.thesii.Wintermute.Linguistics.Error.Overloaded";
+            sendErrorReply (l_nm, Scheduler::describe ((Scheduler::Decision) p_dcsn));
         }
     }
 }
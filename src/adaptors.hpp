@@ -24,11 +24,15 @@
 #ifndef WNTRLING_ADAPTORS_HPP
 #define WNTRLING_ADAPTORS_HPP
 
+#include <QList>
+#include <QStringList>
+#include <QVariantMap>
+#include <QtDBus/QDBusContext>
 #include <wntr/adaptors.hpp>
 
 namespace Wintermute {
     namespace Linguistics {
-        class SystemAdaptor : public Adaptor {
+        class SystemAdaptor : public Adaptor, protected QDBusContext {
             Q_OBJECT
             Q_CLASSINFO("D-Bus Interface","org.thesii.Wintermute.Linguistics.System")
 
@@ -38,11 +42,32 @@ namespace Wintermute {
             signals:
                 void started();
                 void stopped();
-                void responseFormed(const QString&);
+                void responseFormed(const qulonglong&, const QList<QByteArray>&);
+                void batchFormed(const qulonglong&, const QList<QList<QByteArray> >&);
+                void requestInterrupted(const qulonglong&, const QString&);
+                void responseShared(const qulonglong&, const QString&, const int&);
+                void resultDropped(const qulonglong&);
+                void parseProgressed(const qulonglong&, const double&, const double&, const qlonglong&);
 
             public slots:
                 virtual void quit() const;
-                void tellSystem(const QString&)const;
+                qulonglong tellSystem(const QString&)const;
+                qulonglong tellSystem(const QString&, const QString&)const;
+                qulonglong tellSystem(const QString&, const QString&, const int&)const;
+                qulonglong tellSystem(const QString&, const QString&, const int&, const int&)const;
+                qulonglong tellSystemBatch(const QStringList&, const QStringList&, const QList<int>&)const;
+                bool cancel(const qulonglong&) const;
+                QVariantMap schedulerMetrics() const;
+                QVariantMap cacheMetrics() const;
+                QVariantMap latencyMetrics() const;
+                bool dumpLatencyMetrics(const QString&) const;
+                void invalidateResults() const;
+                void useSharedResults(const bool&) const;
+                bool releaseResult(const qulonglong&) const;
+
+            private:
+                const QString client() const;
+                void reject(const int&) const;
         };
     }
 }
@@ -0,0 +1,87 @@
+/**
+ * @file    arena.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 7:10 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "arena.hpp"
+
+namespace Wintermute {
+    namespace Linguistics {
+        namespace {
+            /// Every allocation is aligned to this many bytes.
+            const size_t s_algn = 16;
+
+            inline size_t alignUp ( const size_t& p_sz ) {
+                return ( p_sz + s_algn - 1 ) & ~( s_algn - 1 );
+            }
+        }
+
+        Arena::Arena ( const size_t& p_blkSz ) : m_blks(), m_lrg(), m_fnlzrs(), m_fnlCnt(0),
+            m_blkSz(alignUp ( p_blkSz )), m_blk(-1), m_off(0), m_usd(0) { }
+
+        Arena::~Arena() {
+            reset ();
+
+            foreach ( char* l_blk, m_blks )
+                qFree ( l_blk );
+        }
+
+        void* Arena::allocate ( const size_t& p_sz ) {
+            const size_t l_sz = alignUp ( qMax<size_t> ( p_sz, 1 ) );
+            m_usd += l_sz;
+
+            // Anything that'd take up most of a block is given memory of its own.
+            if ( l_sz > m_blkSz / 4 ) {
+                void* l_mem = qMalloc ( l_sz );
+                m_lrg << l_mem;
+                return l_mem;
+            }
+
+            if ( m_blk == -1 || m_off + l_sz > m_blkSz ) {
+                m_blk++;
+                m_off = 0;
+
+                if ( m_blk == m_blks.size () )
+                    m_blks << static_cast<char*> ( qMalloc ( m_blkSz ) );
+            }
+
+            void* l_mem = m_blks.at ( m_blk ) + m_off;
+            m_off += l_sz;
+            return l_mem;
+        }
+
+        void Arena::reset() {
+            while ( m_fnlCnt > 0 ) {
+                const Finalizer& l_fnlzr = m_fnlzrs.at ( --m_fnlCnt );
+                l_fnlzr.m_fn ( l_fnlzr.m_obj );
+            }
+
+            foreach ( void* l_mem, m_lrg )
+                qFree ( l_mem );
+
+            m_lrg.clear ();
+            m_blk = m_blks.isEmpty () ? -1 : 0;
+            m_off = 0;
+            m_usd = 0;
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
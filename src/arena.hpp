@@ -0,0 +1,145 @@
+/**
+ * @file    arena.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 7:10 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __ARENA_HPP__
+#define __ARENA_HPP__
+
+#include <new>
+#include <cstddef>
+#include <QVector>
+
+namespace Wintermute {
+    namespace Linguistics {
+        /**
+         * @brief A bump allocator for the objects that only live as long as a parse.
+         *
+         * A parse forms a great deal of short-lived objects: the Node objects of each
+         * token, Link objects, the Rule and Binding objects used to link them and the
+         * Meaning objects that hold the result. Rather than having each of them allocated
+         * (and never freed) on the heap, the Parser creates them in its Arena.
+         *
+         * Objects are placed back-to-back in large blocks. Calling reset() runs the
+         * destructors of everything created since the last reset, in reverse order,
+         * and rewinds the Arena to its first block; the blocks themselves are kept,
+         * so the next parse allocates without touching the heap.
+         *
+         * @note Objects created in an Arena must never be deleted; they die with reset().
+         * @class Arena arena.hpp "src/arena.hpp"
+         */
+        class Arena {
+            Q_DISABLE_COPY(Arena)
+
+            public:
+                /**
+                 * @brief Default constructor.
+                 * @fn Arena
+                 * @param p_blkSz The size, in bytes, of each block.
+                 */
+                explicit Arena ( const size_t& = 64 * 1024 );
+
+                /**
+                 * @brief Deconstructor; resets the Arena and frees its blocks.
+                 * @fn ~Arena
+                 */
+                ~Arena();
+
+                /**
+                 * @brief Obtains raw, suitably aligned memory from the Arena.
+                 * @fn allocate
+                 * @param p_sz The number of bytes required.
+                 */
+                void* allocate ( const size_t& );
+
+                /**
+                 * @brief Destroys every object created in the Arena and rewinds it.
+                 * @fn reset
+                 */
+                void reset();
+
+                /**
+                 * @brief Obtains the number of bytes handed out since the last reset().
+                 * @fn used
+                 */
+                inline const size_t used() const { return m_usd; }
+
+                /**
+                 * @brief Creates an object in the Arena.
+                 * @fn create
+                 */
+                template<typename T>
+                T* create() {
+                    return track ( new ( allocate ( sizeof ( T ) ) ) T () );
+                }
+
+                template<typename T, typename A1>
+                T* create ( const A1& p_a1 ) {
+                    return track ( new ( allocate ( sizeof ( T ) ) ) T ( p_a1 ) );
+                }
+
+                template<typename T, typename A1, typename A2>
+                T* create ( const A1& p_a1, const A2& p_a2 ) {
+                    return track ( new ( allocate ( sizeof ( T ) ) ) T ( p_a1, p_a2 ) );
+                }
+
+                template<typename T, typename A1, typename A2, typename A3>
+                T* create ( const A1& p_a1, const A2& p_a2, const A3& p_a3 ) {
+                    return track ( new ( allocate ( sizeof ( T ) ) ) T ( p_a1, p_a2, p_a3 ) );
+                }
+
+                template<typename T, typename A1, typename A2, typename A3, typename A4>
+                T* create ( const A1& p_a1, const A2& p_a2, const A3& p_a3, const A4& p_a4 ) {
+                    return track ( new ( allocate ( sizeof ( T ) ) ) T ( p_a1, p_a2, p_a3, p_a4 ) );
+                }
+
+            private:
+                struct Finalizer {
+                    void ( *m_fn ) ( void* );
+                    void* m_obj;
+                };
+
+                template<typename T>
+                static void destroy ( void* p_obj ) { static_cast<T*> ( p_obj )->~T (); }
+
+                template<typename T>
+                T* track ( T* p_obj ) {
+                    if ( m_fnlCnt == m_fnlzrs.size () )
+                        m_fnlzrs.resize ( qMax ( 64, m_fnlzrs.size () * 2 ) );
+
+                    const Finalizer l_fnlzr = { &Arena::destroy<T>, p_obj };
+                    m_fnlzrs[m_fnlCnt++] = l_fnlzr;
+                    return p_obj;
+                }
+
+                QVector<char*> m_blks;
+                QVector<void*> m_lrg;
+                QVector<Finalizer> m_fnlzrs;
+                int m_fnlCnt;
+                size_t m_blkSz;
+                int m_blk;
+                size_t m_off;
+                size_t m_usd;
+        };
+    }
+}
+
+#endif /* __ARENA_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
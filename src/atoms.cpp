@@ -0,0 +1,123 @@
+/**
+ * @file    atoms.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 7:45 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "atoms.hpp"
+#include <QHash>
+#include <QAtomicInt>
+#include <QReadWriteLock>
+
+namespace Wintermute {
+    namespace Linguistics {
+        namespace {
+            /// The strings are stored in fixed chunks that never move, so reading one needs no lock.
+            const int s_chnkBts = 12;
+            const int s_chnkSz = 1 << s_chnkBts;
+            const int s_chnkMx = 1024;
+
+            struct AtomTable {
+                QHash<QString, Atom> m_atms;
+                QString* m_chnks[s_chnkMx];
+                QAtomicInt m_sz;
+                QReadWriteLock m_lck;
+
+                AtomTable() : m_sz(1) {
+                    for ( int i = 0; i < s_chnkMx; ++i )
+                        m_chnks[i] = NULL;
+
+                    m_chnks[0] = new QString[s_chnkSz];
+                    m_atms.insert ( QString(), 0 );
+                }
+            };
+
+            AtomTable& table() {
+                static AtomTable s_tbl;
+                return s_tbl;
+            }
+        }
+
+        /// Only the lookup of a string takes a lock; the slot of an Atom is written before the size that covers it is published.
+        const Atom Atoms::intern ( const QString& p_str ) {
+            if ( p_str.isEmpty () )
+                return 0;
+
+            AtomTable& l_tbl = table ();
+
+            {
+                QReadLocker l_lck ( &l_tbl.m_lck );
+                const QHash<QString, Atom>::ConstIterator l_itr = l_tbl.m_atms.constFind ( p_str );
+                if ( l_itr != l_tbl.m_atms.constEnd () )
+                    return l_itr.value ();
+            }
+
+            QWriteLocker l_lck ( &l_tbl.m_lck );
+            const QHash<QString, Atom>::ConstIterator l_itr = l_tbl.m_atms.constFind ( p_str );
+            if ( l_itr != l_tbl.m_atms.constEnd () )
+                return l_itr.value ();
+
+            const int l_atm = l_tbl.m_sz;
+            const int l_chnk = l_atm >> s_chnkBts;
+            // Only closed vocabularies are interned; running out means something else is being.
+            if ( l_chnk >= s_chnkMx )
+                qFatal ( "(ling) [Atoms] The intern table is full." );
+
+            if ( !l_tbl.m_chnks[l_chnk] )
+                l_tbl.m_chnks[l_chnk] = new QString[s_chnkSz];
+
+            l_tbl.m_chnks[l_chnk][l_atm & ( s_chnkSz - 1 )] = p_str;
+            l_tbl.m_atms.insert ( p_str, l_atm );
+            l_tbl.m_sz.fetchAndStoreRelease ( l_atm + 1 );
+            return l_atm;
+        }
+
+        const bool Atoms::lookup ( const QString& p_str, Atom& p_atm ) {
+            if ( p_str.isEmpty () ) {
+                p_atm = 0;
+                return true;
+            }
+
+            AtomTable& l_tbl = table ();
+            QReadLocker l_lck ( &l_tbl.m_lck );
+            const QHash<QString, Atom>::ConstIterator l_itr = l_tbl.m_atms.constFind ( p_str );
+            if ( l_itr == l_tbl.m_atms.constEnd () )
+                return false;
+
+            p_atm = l_itr.value ();
+            return true;
+        }
+
+        /// An Atom only reaches a caller after intern() published it, so the slot is already visible here.
+        const QString Atoms::toString ( const Atom& p_atm ) {
+            AtomTable& l_tbl = table ();
+
+            if ( p_atm >= ( Atom ) ( int ) l_tbl.m_sz )
+                return QString();
+
+            return l_tbl.m_chnks[p_atm >> s_chnkBts][p_atm & ( s_chnkSz - 1 )];
+        }
+
+        const int Atoms::count() {
+            return table ().m_sz;
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,88 @@
+/**
+ * @file    atoms.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 7:45 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __ATOMS_HPP__
+#define __ATOMS_HPP__
+
+#include <QString>
+
+namespace Wintermute {
+    namespace Linguistics {
+        /**
+         * @brief Represents an interned string.
+         * @see Atoms
+         * @typedef Atom
+         */
+        typedef quint32 Atom;
+
+        /**
+         * @brief The process-wide table of interned strings.
+         *
+         * Interning maps a string to a small, stable integer (an Atom); the same string
+         * always gives the same Atom, so comparing two interned strings is an integer
+         * comparison. The empty string is always Atom 0. Atoms are never released, so
+         * only closed vocabularies are interned: locales, flag keys, rule types and the
+         * names of attributes. Word IDs, flag values and anything else that comes from
+         * users are kept as QString.
+         *
+         * The table is safe to use from any thread. Interning takes a lock; toString() and
+         * count() do not, since interned strings are never moved or changed.
+         *
+         * @class Atoms atoms.hpp "src/atoms.hpp"
+         */
+        class Atoms {
+            public:
+                /**
+                 * @brief Obtains the Atom of a string, interning it if needed.
+                 * @fn intern
+                 * @param p_str The string to intern.
+                 */
+                static const Atom intern ( const QString& );
+
+                /**
+                 * @brief Obtains the Atom of a string, without interning it.
+                 * @fn lookup
+                 * @param p_str The string in question.
+                 * @param p_atm Set to the Atom of the string, if it was interned.
+                 * @return true if the string was interned.
+                 */
+                static const bool lookup ( const QString&, Atom& );
+
+                /**
+                 * @brief Obtains the string an Atom was interned from.
+                 * @fn toString
+                 * @param p_atm The Atom in question.
+                 * @return The string, or an empty QString if the Atom is unknown.
+                 */
+                static const QString toString ( const Atom& );
+
+                /**
+                 * @brief Obtains the number of strings interned so far.
+                 * @fn count
+                 */
+                static const int count();
+        };
+    }
+}
+
+#endif /* __ATOMS_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,131 @@
+/**
+ * @file    cache.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 19, 2026 3:20 AM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "cache.hpp"
+#include "syntax.hpp"
+
+namespace Wintermute {
+    namespace Linguistics {
+        ResultCache::ResultCache ( const qint64& p_cpcty ) : m_ntrs (), m_lru (), m_cpcty ( qMax ( Q_INT64_C ( 0 ), p_cpcty ) ), m_sz ( 0 ),
+            m_hts ( 0 ), m_msss ( 0 ), m_evctns ( 0 ), m_invldtns ( 0 ), m_lck () { }
+
+        const QString ResultCache::keyOf ( const QString& p_lcl, const QString& p_sntnc ) {
+            return p_lcl + QChar ( 0 ) + p_sntnc.simplified ();
+        }
+
+        const bool ResultCache::find ( const QString& p_key, QByteArray& p_rslt ) {
+            const int l_rvsn = Node::revision ();
+            QMutexLocker l_lck ( &m_lck );
+            QHash<QString, Entry>::iterator l_itr = m_ntrs.find ( p_key );
+
+            if ( l_itr == m_ntrs.end () ) {
+                m_msss++;
+                return false;
+            }
+
+            if ( l_itr->m_rvsn != l_rvsn ) {
+                remove ( l_itr );
+                m_msss++;
+                return false;
+            }
+
+            // Move the entry to the front; the back is the next to go.
+            m_lru.erase ( l_itr->m_pos );
+            l_itr->m_pos = m_lru.insert ( m_lru.begin (), p_key );
+            p_rslt = l_itr->m_rslt;
+            m_hts++;
+            return true;
+        }
+
+        void ResultCache::insert ( const QString& p_key, const QByteArray& p_rslt, const int& p_rvsn ) {
+            const qint64 l_sz = p_key.size () * sizeof ( QChar ) + p_rslt.size () + sizeof ( Entry ) + sizeof ( QString );
+            QMutexLocker l_lck ( &m_lck );
+
+            if ( l_sz > m_cpcty || p_rvsn != Node::revision () )
+                return;
+
+            QHash<QString, Entry>::iterator l_itr = m_ntrs.find ( p_key );
+            if ( l_itr != m_ntrs.end () )
+                remove ( l_itr );
+
+            Entry l_ntry;
+            l_ntry.m_rslt = p_rslt;
+            l_ntry.m_rvsn = p_rvsn;
+            l_ntry.m_sz = l_sz;
+            l_ntry.m_pos = m_lru.insert ( m_lru.begin (), p_key );
+            m_ntrs.insert ( p_key, l_ntry );
+            m_sz += l_sz;
+
+            trim ();
+        }
+
+        void ResultCache::invalidate() {
+            QMutexLocker l_lck ( &m_lck );
+            m_ntrs.clear ();
+            m_lru.clear ();
+            m_sz = 0;
+            m_invldtns++;
+        }
+
+        const qint64 ResultCache::capacity() const {
+            QMutexLocker l_lck ( &m_lck );
+            return m_cpcty;
+        }
+
+        void ResultCache::setCapacity ( const qint64& p_cpcty ) {
+            QMutexLocker l_lck ( &m_lck );
+            m_cpcty = qMax ( Q_INT64_C ( 0 ), p_cpcty );
+            trim ();
+        }
+
+        const QVariantMap ResultCache::metrics() const {
+            QMutexLocker l_lck ( &m_lck );
+            const quint64 l_lkps = m_hts + m_msss;
+            QVariantMap l_mtrcs;
+
+            l_mtrcs.insert ( "hits", m_hts );
+            l_mtrcs.insert ( "misses", m_msss );
+            l_mtrcs.insert ( "hitRate", l_lkps == 0 ? 0.0 : (double) m_hts / (double) l_lkps );
+            l_mtrcs.insert ( "entries", m_ntrs.size () );
+            l_mtrcs.insert ( "bytes", m_sz );
+            l_mtrcs.insert ( "capacity", m_cpcty );
+            l_mtrcs.insert ( "evictions", m_evctns );
+            l_mtrcs.insert ( "invalidations", m_invldtns );
+            return l_mtrcs;
+        }
+
+        void ResultCache::remove ( const QHash<QString, Entry>::iterator& p_itr ) {
+            m_sz -= p_itr->m_sz;
+            m_lru.erase ( p_itr->m_pos );
+            m_ntrs.erase ( p_itr );
+        }
+
+        void ResultCache::trim() {
+            while ( m_sz > m_cpcty && !m_lru.isEmpty () ) {
+                remove ( m_ntrs.find ( m_lru.last () ) );
+                m_evctns++;
+            }
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
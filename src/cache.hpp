@@ -0,0 +1,142 @@
+/**
+ * @file    cache.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 19, 2026 3:20 AM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __CACHE_HPP__
+#define __CACHE_HPP__
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QByteArray>
+#include <QLinkedList>
+#include <QVariantMap>
+
+namespace Wintermute {
+    namespace Linguistics {
+        /**
+         * @brief Remembers the result of parsing a sentence, so repeated sentences aren't parsed again.
+         *
+         * Results are kept by locale and normalized sentence, and the least recently
+         * used ones are dropped once their total size goes over the capacity. Every
+         * result is stamped with the Node::revision() it was parsed at; a result from
+         * an older revision of the lexicon is never handed out. Changes to the rules
+         * aren't seen by the lexicon revision and call for invalidate().
+         *
+         * The cache is safe to use from any thread.
+         *
+         * @class ResultCache cache.hpp "src/cache.hpp"
+         */
+        class ResultCache {
+            Q_DISABLE_COPY(ResultCache)
+
+            public:
+                /**
+                 * @brief Default constructor.
+                 * @fn ResultCache
+                 * @param p_cpcty The most bytes of keys and results held at once.
+                 */
+                explicit ResultCache ( const qint64& = 8 * 1024 * 1024 );
+
+                /**
+                 * @brief Forms the key of a sentence.
+                 *
+                 * Leading, trailing and repeated whitespace (line breaks included) don't
+                 * count towards the key.
+                 *
+                 * @fn keyOf
+                 * @param p_lcl The locale of the sentence.
+                 * @param p_sntnc The sentence.
+                 */
+                static const QString keyOf ( const QString&, const QString& );
+
+                /**
+                 * @brief Looks up the result of a sentence.
+                 * @fn find
+                 * @param p_key The key of the sentence, from keyOf().
+                 * @param p_rslt Set to the result, if one's found.
+                 * @return true if a result was found.
+                 */
+                const bool find ( const QString&, QByteArray& );
+
+                /**
+                 * @brief Remembers the result of a sentence.
+                 * @fn insert
+                 * @param p_key The key of the sentence, from keyOf().
+                 * @param p_rslt The result.
+                 * @param p_rvsn The Node::revision() the sentence was parsed at.
+                 */
+                void insert ( const QString&, const QByteArray&, const int& );
+
+                /**
+                 * @brief Forgets every result.
+                 * @fn invalidate
+                 */
+                void invalidate();
+
+                /**
+                 * @brief Obtains the most bytes held at once.
+                 * @fn capacity
+                 */
+                const qint64 capacity() const;
+
+                /**
+                 * @brief Changes the most bytes held at once, dropping results if need be.
+                 * @fn setCapacity
+                 * @param p_cpcty The number of bytes; 0 turns the cache off.
+                 */
+                void setCapacity ( const qint64& );
+
+                /**
+                 * @brief Obtains the counters of the cache.
+                 *
+                 * The map holds "hits", "misses", "hitRate", "entries", "bytes",
+                 * "capacity", "evictions" and "invalidations".
+                 *
+                 * @fn metrics
+                 */
+                const QVariantMap metrics() const;
+
+            private:
+                struct Entry {
+                    QByteArray m_rslt;
+                    int m_rvsn;
+                    qint64 m_sz;
+                    QLinkedList<QString>::iterator m_pos;
+                };
+
+                void remove ( const QHash<QString, Entry>::iterator& );
+                void trim();
+                QHash<QString, Entry> m_ntrs;
+                QLinkedList<QString> m_lru;
+                qint64 m_cpcty;
+                qint64 m_sz;
+                quint64 m_hts;
+                quint64 m_msss;
+                quint64 m_evctns;
+                quint64 m_invldtns;
+                mutable QMutex m_lck;
+        };
+    }
+}
+
+#endif /* __CACHE_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,45 @@
+/**
+ * @file    cancel.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 10:05 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "cancel.hpp"
+
+namespace Wintermute {
+    namespace Linguistics {
+        CancelToken::CancelToken ( const int& p_ddln ) : m_cncld ( 0 ), m_tmr (), m_ddln ( p_ddln > 0 ? p_ddln : -1 ) {
+            m_tmr.start ();
+        }
+
+        void CancelToken::cancel() {
+            m_cncld.fetchAndStoreOrdered ( 1 );
+        }
+
+        const bool CancelToken::isCancelled() const {
+            return m_cncld != 0;
+        }
+
+        const bool CancelToken::isTimedOut() const {
+            return m_ddln >= 0 && m_tmr.hasExpired ( m_ddln );
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
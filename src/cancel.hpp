@@ -0,0 +1,92 @@
+/**
+ * @file    cancel.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 10:05 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __CANCEL_HPP__
+#define __CANCEL_HPP__
+
+#include <QAtomicInt>
+#include <QElapsedTimer>
+
+namespace Wintermute {
+    namespace Linguistics {
+        /**
+         * @brief Lets a parse be called off, by request or once a deadline passes.
+         *
+         * The Parser and Meaning::form() poll the token they're handed between units
+         * of work (each token, word, path and round of linking) and wind down as soon
+         * as it has expired, keeping whatever they've found so far. Cancelling is safe
+         * from any thread.
+         *
+         * @class CancelToken cancel.hpp "src/cancel.hpp"
+         */
+        class CancelToken {
+            Q_DISABLE_COPY(CancelToken)
+
+            public:
+                /**
+                 * @brief Default constructor.
+                 * @fn CancelToken
+                 * @param p_ddln The number of milliseconds from now the work has to be done in, or 0 for no deadline.
+                 */
+                explicit CancelToken ( const int& = 0 );
+
+                /**
+                 * @brief Calls off the work.
+                 * @fn cancel
+                 */
+                void cancel();
+
+                /**
+                 * @brief Determines if the work was called off by cancel().
+                 * @fn isCancelled
+                 */
+                const bool isCancelled() const;
+
+                /**
+                 * @brief Determines if the deadline has passed.
+                 * @fn isTimedOut
+                 */
+                const bool isTimedOut() const;
+
+                /**
+                 * @brief Determines if the work should stop, for either reason.
+                 * @fn hasExpired
+                 */
+                inline const bool hasExpired() const { return isCancelled () || isTimedOut (); }
+
+                /**
+                 * @brief Determines if a token (which may be NULL) has expired.
+                 * @fn hasExpired
+                 * @param p_tkn The token in question.
+                 */
+                static inline const bool hasExpired ( const CancelToken* p_tkn ) { return p_tkn && p_tkn->hasExpired (); }
+
+            private:
+                QAtomicInt m_cncld;
+                QElapsedTimer m_tmr;
+                qint64 m_ddln;
+        };
+    }
+}
+
+#endif /* __CANCEL_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
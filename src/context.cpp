@@ -0,0 +1,91 @@
+/**
+ * @file    context.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 11:40 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "context.hpp"
+
+namespace Wintermute {
+    namespace Linguistics {
+        namespace {
+            /// clear() would free the storage in Qt 4; a reserved QVector keeps it when resized.
+            template<typename T>
+            inline void empty ( QVector<T>& p_vctr ) {
+                p_vctr.reserve ( p_vctr.capacity () );
+                p_vctr.resize ( 0 );
+            }
+
+            /// Erasing from a QList keeps its storage, unlike clear().
+            template<typename T>
+            inline void empty ( QList<T>& p_lst ) {
+                p_lst.erase ( p_lst.begin (), p_lst.end () );
+            }
+        }
+
+        ParseContext::ParseContext ( const CancelToken* p_tkn ) : m_tkn ( p_tkn ), m_lkp ( NULL ), m_arn (), m_sntncs (), m_sntncCnt ( 0 ), m_tknStr (),
+            m_vrnts (), m_pths (), m_pth (), m_prg ( 0 ), m_prgMax ( 0 ), m_sntnc ( 0 ), m_prgTmr (), m_prgLst ( 0 ), m_lvl ( 0 ), m_mxLvls ( 5 ),
+            m_rnd (), m_nxtRnd (), m_hdLst (), m_hdOthr ( false ), m_hdThs ( false ),
+            m_rslts (), m_keys (), m_dn (), m_rvsn ( 0 ) { }
+
+        ParseContext::~ParseContext() {
+            delete m_lkp;
+        }
+
+        ParseContext* ParseContext::lookupContext() {
+            if ( !m_lkp )
+                m_lkp = new ParseContext;
+
+            m_lkp->m_tkn = m_tkn;
+            return m_lkp;
+        }
+
+        void ParseContext::beginRound() {
+            empty ( m_nxtRnd );
+            empty ( m_hdLst );
+            m_hdOthr = false;
+            m_hdThs = false;
+        }
+
+        void ParseContext::reset() {
+            // The Node objects the buffers point at live in the Arena; let go of them first.
+            empty ( m_rnd );
+            empty ( m_nxtRnd );
+            empty ( m_vrnts );
+            m_pths.clear ();
+            empty ( m_pth );
+            m_tknStr.clear ();
+            m_sntncCnt = 0;
+            empty ( m_hdLst );
+            empty ( m_keys );
+            empty ( m_dn );
+            m_prg = m_prgMax = 0;
+            m_sntnc = 0;
+            m_prgLst = 0;
+            m_prgTmr.invalidate ();
+            m_lvl = 0;
+            m_arn.reset ();
+
+            if ( m_lkp )
+                m_lkp->reset ();
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,200 @@
+/**
+ * @file    context.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 11:40 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __CONTEXT_HPP__
+#define __CONTEXT_HPP__
+
+#include <QVector>
+#include <QStringList>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include "syntax.hpp"
+#include "tokens.hpp"
+#include "arena.hpp"
+#include "paths.hpp"
+#include "cancel.hpp"
+
+namespace Wintermute {
+    namespace Linguistics {
+        class Parser;
+        class Meaning;
+        class LookupStage;
+
+        /**
+         * @brief Holds everything a single parse works with.
+         *
+         * The tokens, Node variants and paths of the sentence at hand, the Arena
+         * everything is formed in, the progress through the paths, the level of the
+         * linking round in Meaning::form() (written into each Link formed) and the
+         * hide/skip state and scratch buffers of that round all live here rather than
+         * in the Parser or in statics. Parses with their own ParseContext don't share
+         * anything mutable, so any number of them can run at once without locking.
+         *
+         * A ParseContext is meant to be reused; its buffers keep their capacity from
+         * one text to the next. When the sentences of a text are parsed in stages,
+         * the lookup stage works in a second ParseContext owned by this one, with an
+         * Arena of its own, while the linking stage works in this one.
+         *
+         * @see Parser::parse()
+         * @class ParseContext context.hpp "src/context.hpp"
+         */
+        class ParseContext {
+            Q_DISABLE_COPY(ParseContext)
+            friend class Parser;
+            friend class Meaning;
+            friend class LookupStage;
+
+            public:
+                /**
+                 * @brief Default constructor.
+                 * @fn ParseContext
+                 * @param p_tkn The CancelToken to heed, or NULL.
+                 */
+                explicit ParseContext ( const CancelToken* = NULL );
+
+                /**
+                 * @brief Deconstructor.
+                 * @fn ~ParseContext
+                 */
+                ~ParseContext();
+
+                /**
+                 * @brief Obtains the CancelToken heeded by the parse.
+                 * @fn cancelToken
+                 */
+                inline const CancelToken* cancelToken() const { return m_tkn; }
+
+                /**
+                 * @brief Changes the CancelToken heeded by the parse.
+                 * @fn setCancelToken
+                 * @param p_tkn The CancelToken, or NULL.
+                 */
+                inline void setCancelToken ( const CancelToken* p_tkn = NULL ) { m_tkn = p_tkn; }
+
+                /**
+                 * @brief Determines if the parse should stop.
+                 * @fn hasExpired
+                 */
+                inline const bool hasExpired() const { return CancelToken::hasExpired ( m_tkn ); }
+
+                /**
+                 * @brief Obtains the Arena the parse forms its objects in.
+                 * @fn arena
+                 */
+                inline Arena* arena() { return &m_arn; }
+
+                /**
+                 * @brief Obtains the level of the current round of linking.
+                 * @fn level
+                 */
+                inline const int level() const { return m_lvl; }
+
+                /**
+                 * @brief Obtains the most rounds of linking a path may take.
+                 * @fn maxLevels
+                 */
+                inline const int maxLevels() const { return m_mxLvls; }
+
+                /**
+                 * @brief Changes the most rounds of linking a path may take.
+                 *
+                 * A path still leaving Node objects to link after that many rounds is
+                 * given up on.
+                 *
+                 * @fn setMaxLevels
+                 * @param p_lvls The number of rounds.
+                 */
+                inline void setMaxLevels ( const int& p_lvls = 5 ) { m_mxLvls = p_lvls; }
+
+                /**
+                 * @brief Obtains the number of paths of the current sentence tried so far.
+                 * @fn progress
+                 */
+                inline const PathIndex progress() const { return m_prg; }
+
+                /**
+                 * @brief Obtains the number of paths of the current sentence that will be tried.
+                 * @fn progressMax
+                 */
+                inline const PathIndex progressMax() const { return m_prgMax; }
+
+                /**
+                 * @brief Obtains the index of the sentence whose paths are being tried.
+                 * @fn sentence
+                 */
+                inline const int sentence() const { return m_sntnc; }
+
+                /**
+                 * @brief Obtains the result of each sentence of the last text parsed.
+                 *
+                 * A sentence that formed no meaning, or wasn't reached before the parse
+                 * was called off, has an empty result.
+                 *
+                 * @fn results
+                 * @see Parser::resultOf()
+                 */
+                inline const QVector<QByteArray>& results() const { return m_rslts; }
+
+                /**
+                 * @brief Releases everything formed for the last text.
+                 *
+                 * Every object in the Arena is destroyed; the buffers are emptied but
+                 * keep their capacity. The results() are kept until the next parse.
+                 *
+                 * @fn reset
+                 */
+                void reset();
+
+            private:
+                void beginRound();
+                ParseContext* lookupContext();
+                const CancelToken* m_tkn;
+                ParseContext* m_lkp;
+                Arena m_arn;
+                SentenceList m_sntncs;
+                int m_sntncCnt;
+                TokenStore m_tknStr;
+                QVector<NodeList> m_vrnts;
+                PathSpace m_pths;
+                NodeCodeList m_pth;
+                PathIndex m_prg;
+                PathIndex m_prgMax;
+                int m_sntnc;
+                QElapsedTimer m_prgTmr;
+                qint64 m_prgLst;
+                int m_lvl;
+                int m_mxLvls;
+                NodeList m_rnd;
+                NodeList m_nxtRnd;
+                QStringList m_hdLst;
+                bool m_hdOthr;
+                bool m_hdThs;
+                QVector<QByteArray> m_rslts;
+                QVector<QString> m_keys;
+                QVector<bool> m_dn;
+                int m_rvsn;
+        };
+    }
+}
+
+#endif /* __CONTEXT_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
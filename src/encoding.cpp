@@ -0,0 +1,238 @@
+/**
+ * @file    encoding.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 19, 2026 8:30 AM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "encoding.hpp"
+#include "meanings.hpp"
+#include <cstring>
+#include <QHash>
+#include <QVector>
+#include <QtEndian>
+
+namespace Wintermute {
+    namespace Linguistics {
+        namespace {
+            const char s_mgc[4] = { 'W', 'L', 'M', 'N' };
+
+            void putWord ( QByteArray& p_dt, const quint32& p_wrd ) {
+                uchar l_bts[4];
+                qToLittleEndian ( p_wrd, l_bts );
+                p_dt.append ( reinterpret_cast<const char*> ( l_bts ), 4 );
+            }
+
+            /// Gives each distinct string a string index, in the order they're met.
+            quint32 indexOf ( QHash<QString, quint32>& p_idx, QVector<QString>& p_strs, const QString& p_str ) {
+                if ( p_str.isEmpty () )
+                    return 0;
+
+                QHash<QString, quint32>::ConstIterator l_itr = p_idx.constFind ( p_str );
+                if ( l_itr == p_idx.constEnd () ) {
+                    l_itr = p_idx.insert ( p_str, p_strs.size () );
+                    p_strs << p_str;
+                }
+
+                return l_itr.value ();
+            }
+        }
+
+        const QByteArray MeaningEncoding::encode ( const Meaning& p_mng ) {
+            const LinkList& l_lnks = p_mng.m_lnkVtr;
+            QVector<const Node*> l_nds ( p_mng.m_ndIdx.size () );
+            QHash<QString, quint32> l_strIdx;
+            QVector<QString> l_strs;
+            QVector<quint32> l_ndRcs, l_lnkRcs;
+            l_strs << QString ();
+
+            for ( QHash<const Node*, int>::ConstIterator l_itr = p_mng.m_ndIdx.constBegin (); l_itr != p_mng.m_ndIdx.constEnd (); l_itr++ )
+                l_nds[l_itr.value ()] = l_itr.key ();
+
+            l_ndRcs.reserve ( l_nds.size () * 3 );
+            foreach ( const Node* l_nd, l_nds ) {
+                l_ndRcs << indexOf ( l_strIdx, l_strs, l_nd->id () )
+                        << indexOf ( l_strIdx, l_strs, l_nd->locale () )
+                        << indexOf ( l_strIdx, l_strs, l_nd->toString ( Node::EXTRA ) );
+            }
+
+            l_lnkRcs.reserve ( l_lnks.size () * 5 );
+            foreach ( const Link* l_lnk, l_lnks ) {
+                l_lnkRcs << p_mng.m_ndIdx.value ( l_lnk->source () )
+                         << p_mng.m_ndIdx.value ( l_lnk->destination () )
+                         << indexOf ( l_strIdx, l_strs, l_lnk->flags () )
+                         << indexOf ( l_strIdx, l_strs, l_lnk->locale () )
+                         << qMax ( 0, l_lnk->level () );
+            }
+
+            QByteArray l_strDt;
+            QVector<quint32> l_strOfs;
+            l_strOfs.reserve ( l_strs.size () + 1 );
+            foreach ( const QString& l_str, l_strs ) {
+                l_strOfs << l_strDt.size ();
+                l_strDt += l_str.toUtf8 ();
+            }
+            l_strOfs << l_strDt.size ();
+
+            QByteArray l_dt;
+            l_dt.reserve ( HeaderSize + ( l_ndRcs.size () + l_lnkRcs.size () + l_strOfs.size () ) * 4 + l_strDt.size () );
+            l_dt.append ( s_mgc, 4 );
+
+            uchar l_vrsn[4];
+            qToLittleEndian<quint16> ( Version, l_vrsn );
+            qToLittleEndian<quint16> ( 0, l_vrsn + 2 );
+            l_dt.append ( reinterpret_cast<const char*> ( l_vrsn ), 4 );
+
+            putWord ( l_dt, l_nds.size () );
+            putWord ( l_dt, l_lnks.size () );
+            putWord ( l_dt, l_strs.size () );
+            putWord ( l_dt, l_strDt.size () );
+
+            foreach ( const quint32& l_wrd, l_ndRcs )
+                putWord ( l_dt, l_wrd );
+
+            foreach ( const quint32& l_wrd, l_lnkRcs )
+                putWord ( l_dt, l_wrd );
+
+            foreach ( const quint32& l_wrd, l_strOfs )
+                putWord ( l_dt, l_wrd );
+
+            l_dt += l_strDt;
+            return l_dt;
+        }
+
+        MeaningReader::MeaningReader ( const QByteArray& p_dt ) : m_dt ( p_dt ), m_vld ( false ), m_nds ( 0 ), m_lnks ( 0 ), m_strs ( 0 ),
+            m_ndOfs ( 0 ), m_lnkOfs ( 0 ), m_strOfs ( 0 ), m_strDtOfs ( 0 ) {
+            if ( m_dt.size () < MeaningEncoding::HeaderSize || memcmp ( m_dt.constData (), s_mgc, 4 ) != 0 || version () != MeaningEncoding::Version )
+                return;
+
+            const quint32 l_nds = word ( 8 ), l_lnks = word ( 12 ), l_strs = word ( 16 ), l_strDt = word ( 20 );
+            const qint64 l_sz = (qint64) MeaningEncoding::HeaderSize + (qint64) l_nds * MeaningEncoding::NodeRecordSize
+                              + (qint64) l_lnks * MeaningEncoding::LinkRecordSize + ( (qint64) l_strs + 1 ) * 4 + l_strDt;
+
+            if ( l_strs == 0 || l_sz != m_dt.size () )
+                return;
+
+            m_nds = l_nds;
+            m_lnks = l_lnks;
+            m_strs = l_strs;
+            m_ndOfs = MeaningEncoding::HeaderSize;
+            m_lnkOfs = m_ndOfs + m_nds * MeaningEncoding::NodeRecordSize;
+            m_strOfs = m_lnkOfs + m_lnks * MeaningEncoding::LinkRecordSize;
+            m_strDtOfs = m_strOfs + ( m_strs + 1 ) * 4;
+
+            // Check every reference once, so the accessors needn't.
+            for ( int l_i = 0; l_i < m_strs; l_i++ ) {
+                if ( word ( m_strOfs + l_i * 4 ) > word ( m_strOfs + ( l_i + 1 ) * 4 ) )
+                    return;
+            }
+
+            if ( word ( m_strOfs + m_strs * 4 ) != l_strDt )
+                return;
+
+            for ( int l_i = 0; l_i < m_nds * 3; l_i++ ) {
+                if ( word ( m_ndOfs + l_i * 4 ) >= (quint32) m_strs )
+                    return;
+            }
+
+            for ( int l_i = 0; l_i < m_lnks; l_i++ ) {
+                const int l_rc = m_lnkOfs + l_i * MeaningEncoding::LinkRecordSize;
+                if ( word ( l_rc ) >= (quint32) m_nds || word ( l_rc + 4 ) >= (quint32) m_nds ||
+                     word ( l_rc + 8 ) >= (quint32) m_strs || word ( l_rc + 12 ) >= (quint32) m_strs )
+                    return;
+            }
+
+            m_vld = true;
+        }
+
+        const int MeaningReader::version() const {
+            if ( m_dt.size () < 6 )
+                return 0;
+
+            return qFromLittleEndian<quint16> ( reinterpret_cast<const uchar*> ( m_dt.constData () ) + 4 );
+        }
+
+        const int MeaningReader::levels() const {
+            int l_lvls = 0;
+            for ( int l_i = 0; l_i < m_lnks; l_i++ )
+                l_lvls = qMax ( l_lvls, linkLevel ( l_i ) );
+
+            return l_lvls;
+        }
+
+        const QString MeaningReader::nodeId ( const int& p_nd ) const {
+            return QString::fromUtf8 ( stringAt ( nodeField ( p_nd, 0 ) ) );
+        }
+
+        const QString MeaningReader::nodeLocale ( const int& p_nd ) const {
+            return QString::fromUtf8 ( stringAt ( nodeField ( p_nd, 1 ) ) );
+        }
+
+        const QString MeaningReader::nodeType ( const int& p_nd ) const {
+            return QString::fromUtf8 ( stringAt ( nodeField ( p_nd, 2 ) ) );
+        }
+
+        const int MeaningReader::linkSource ( const int& p_lnk ) const {
+            return linkField ( p_lnk, 0 );
+        }
+
+        const int MeaningReader::linkDestination ( const int& p_lnk ) const {
+            return linkField ( p_lnk, 1 );
+        }
+
+        const QString MeaningReader::linkFlags ( const int& p_lnk ) const {
+            return QString::fromUtf8 ( stringAt ( linkField ( p_lnk, 2 ) ) );
+        }
+
+        const QString MeaningReader::linkLocale ( const int& p_lnk ) const {
+            return QString::fromUtf8 ( stringAt ( linkField ( p_lnk, 3 ) ) );
+        }
+
+        const int MeaningReader::linkLevel ( const int& p_lnk ) const {
+            return linkField ( p_lnk, 4 );
+        }
+
+        const QByteArray MeaningReader::stringAt ( const int& p_str ) const {
+            if ( !m_vld || p_str <= 0 || p_str >= m_strs )
+                return QByteArray ();
+
+            const quint32 l_bgn = word ( m_strOfs + p_str * 4 ), l_end = word ( m_strOfs + ( p_str + 1 ) * 4 );
+            return QByteArray::fromRawData ( m_dt.constData () + m_strDtOfs + l_bgn, l_end - l_bgn );
+        }
+
+        const quint32 MeaningReader::word ( const int& p_ofs ) const {
+            return qFromLittleEndian<quint32> ( reinterpret_cast<const uchar*> ( m_dt.constData () ) + p_ofs );
+        }
+
+        const quint32 MeaningReader::nodeField ( const int& p_nd, const int& p_fld ) const {
+            if ( !m_vld || p_nd < 0 || p_nd >= m_nds )
+                return 0;
+
+            return word ( m_ndOfs + p_nd * MeaningEncoding::NodeRecordSize + p_fld * 4 );
+        }
+
+        const quint32 MeaningReader::linkField ( const int& p_lnk, const int& p_fld ) const {
+            if ( !m_vld || p_lnk < 0 || p_lnk >= m_lnks )
+                return 0;
+
+            return word ( m_lnkOfs + p_lnk * MeaningEncoding::LinkRecordSize + p_fld * 4 );
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,203 @@
+/**
+ * @file    encoding.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 19, 2026 8:30 AM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __ENCODING_HPP__
+#define __ENCODING_HPP__
+
+#include <QString>
+#include <QByteArray>
+
+namespace Wintermute {
+    namespace Linguistics {
+        class Meaning;
+
+        /**
+         * @brief Encodes a Meaning into its compact binary form.
+         *
+         * Every integer is a little-endian quint32, so records can be read in place
+         * and the encoding doesn't depend on the machine that wrote it:
+         *
+         * @li a header of 24 bytes: the magic "WLMN", a quint16 version and a quint16
+         *     left at 0, then the number of Node records, of Link records, of strings
+         *     and of bytes of string data;
+         * @li a record per Node: its ID, locale and type (Node::toString(Node::EXTRA)),
+         *     each the index of a string;
+         * @li a record per Link, the base Link last: the index of its source and
+         *     destination Node records, the strings of its flags and locale, and its level;
+         * @li the offset of each string in the string data, and one more for its end;
+         * @li the string data, UTF-8 encoded, with each string written once.
+         *
+         * String 0 is always the empty string.
+         *
+         * @see MeaningReader
+         * @class MeaningEncoding encoding.hpp "src/encoding.hpp"
+         */
+        class MeaningEncoding {
+            public:
+                enum {
+                    Version = 1, /**< The version written by encode(). */
+                    HeaderSize = 24,
+                    NodeRecordSize = 12,
+                    LinkRecordSize = 20
+                };
+
+                /**
+                 * @brief Encodes a Meaning.
+                 * @fn encode
+                 * @param p_mng The Meaning to be encoded.
+                 */
+                static const QByteArray encode ( const Meaning& );
+        };
+
+        /**
+         * @brief Reads an encoded Meaning in place.
+         *
+         * The encoded bytes are checked once, when the reader is formed; after that
+         * every accessor reads straight from them, and nothing is copied or decoded
+         * until a string is asked for. The reader shares the QByteArray it's given, so
+         * one made with QByteArray::fromRawData() reads memory it doesn't own (say, a
+         * shared memory segment), which has to outlive the reader.
+         *
+         * @see MeaningEncoding
+         * @class MeaningReader encoding.hpp "src/encoding.hpp"
+         */
+        class MeaningReader {
+            public:
+                /**
+                 * @brief Default constructor.
+                 * @fn MeaningReader
+                 * @param p_dt The encoded Meaning.
+                 */
+                explicit MeaningReader ( const QByteArray& = QByteArray() );
+
+                /**
+                 * @brief Determines if the bytes hold a Meaning this reader understands.
+                 * @fn isValid
+                 */
+                inline const bool isValid() const { return m_vld; }
+
+                /**
+                 * @brief Obtains the version of the encoding.
+                 * @fn version
+                 */
+                const int version() const;
+
+                /**
+                 * @brief Obtains the number of Node records.
+                 * @fn nodeCount
+                 */
+                inline const int nodeCount() const { return m_nds; }
+
+                /**
+                 * @brief Obtains the number of Link records.
+                 * @fn linkCount
+                 */
+                inline const int linkCount() const { return m_lnks; }
+
+                /**
+                 * @brief Obtains the number of levels of the Meaning.
+                 * @fn levels
+                 */
+                const int levels() const;
+
+                /**
+                 * @brief Obtains the ID of a Node.
+                 * @fn nodeId
+                 * @param p_nd The index of the Node record.
+                 */
+                const QString nodeId ( const int& ) const;
+
+                /**
+                 * @brief Obtains the locale of a Node.
+                 * @fn nodeLocale
+                 * @param p_nd The index of the Node record.
+                 */
+                const QString nodeLocale ( const int& ) const;
+
+                /**
+                 * @brief Obtains the type of a Node, as Node::toString(Node::EXTRA) would.
+                 * @fn nodeType
+                 * @param p_nd The index of the Node record.
+                 */
+                const QString nodeType ( const int& ) const;
+
+                /**
+                 * @brief Obtains the index of the source Node of a Link.
+                 * @fn linkSource
+                 * @param p_lnk The index of the Link record.
+                 */
+                const int linkSource ( const int& ) const;
+
+                /**
+                 * @brief Obtains the index of the destination Node of a Link.
+                 * @fn linkDestination
+                 * @param p_lnk The index of the Link record.
+                 */
+                const int linkDestination ( const int& ) const;
+
+                /**
+                 * @brief Obtains the flags of a Link.
+                 * @fn linkFlags
+                 * @param p_lnk The index of the Link record.
+                 */
+                const QString linkFlags ( const int& ) const;
+
+                /**
+                 * @brief Obtains the locale of a Link.
+                 * @fn linkLocale
+                 * @param p_lnk The index of the Link record.
+                 */
+                const QString linkLocale ( const int& ) const;
+
+                /**
+                 * @brief Obtains the level of a Link.
+                 * @fn linkLevel
+                 * @param p_lnk The index of the Link record.
+                 */
+                const int linkLevel ( const int& ) const;
+
+                /**
+                 * @brief Obtains the UTF-8 bytes of a string, without copying them.
+                 * @fn stringAt
+                 * @param p_str The index of the string.
+                 */
+                const QByteArray stringAt ( const int& ) const;
+
+            private:
+                const quint32 word ( const int& ) const;
+                const quint32 nodeField ( const int&, const int& ) const;
+                const quint32 linkField ( const int&, const int& ) const;
+                QByteArray m_dt;
+                bool m_vld;
+                int m_nds;
+                int m_lnks;
+                int m_strs;
+                int m_ndOfs;
+                int m_lnkOfs;
+                int m_strOfs;
+                int m_strDtOfs;
+        };
+    }
+}
+
+#endif /* __ENCODING_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
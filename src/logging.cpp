@@ -0,0 +1,181 @@
+/**
+ * @file    logging.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 19, 2026 2:20 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "logging.hpp"
+#include <cstdio>
+#include <QMutex>
+#include <QThread>
+#include <QVector>
+#include <QAtomicInt>
+#include <QWaitCondition>
+
+namespace Wintermute {
+    namespace Linguistics {
+        namespace {
+            QAtomicInt s_lvl ( WNTRLING_LOG_LEVEL );
+
+            struct LogEntry {
+                int m_lvl;
+                const char* m_cmp;
+                QString m_txt;
+            };
+
+            /// The ring buffer of Log and the thread draining it to standard error.
+            class LogRing : public QThread {
+                public:
+                    enum { Capacity = 4096 };
+
+                    LogRing() : m_rng ( Capacity ), m_hd ( 0 ), m_sz ( 0 ), m_drpd ( 0 ), m_unrprtd ( 0 ), m_bsy ( false ), m_stp ( false ) {
+                        start ( QThread::LowPriority );
+                    }
+
+                    ~LogRing() {
+                        m_lck.lock ();
+                        m_stp = true;
+                        m_wk.wakeOne ();
+                        m_lck.unlock ();
+                        wait ();
+                    }
+
+                    void push ( const int& p_lvl, const char* p_cmp, const QString& p_txt ) {
+                        QMutexLocker l_lckr ( &m_lck );
+
+                        if ( m_sz == Capacity ) {
+                            m_hd = ( m_hd + 1 ) % Capacity;
+                            m_sz--;
+                            m_drpd++;
+                            m_unrprtd++;
+                        }
+
+                        LogEntry& l_entry = m_rng[( m_hd + m_sz ) % Capacity];
+                        l_entry.m_lvl = p_lvl;
+                        l_entry.m_cmp = p_cmp;
+                        l_entry.m_txt = p_txt;
+                        m_sz++;
+                        m_wk.wakeOne ();
+                    }
+
+                    void flush() {
+                        QMutexLocker l_lckr ( &m_lck );
+                        while ( m_sz > 0 || m_bsy )
+                            m_drnd.wait ( &m_lck );
+                    }
+
+                    const qulonglong dropped() {
+                        QMutexLocker l_lckr ( &m_lck );
+                        return m_drpd;
+                    }
+
+                protected:
+                    void run() {
+                        static const char* const s_lvlNms[] = { "trace", "debug", "info", "warning", "error" };
+                        QVector<LogEntry> l_btch;
+
+                        forever {
+                            qulonglong l_unrprtd = 0;
+                            l_btch.clear ();
+
+                            {
+                                QMutexLocker l_lckr ( &m_lck );
+                                while ( m_sz == 0 && !m_stp ) {
+                                    m_drnd.wakeAll ();
+                                    m_wk.wait ( &m_lck );
+                                }
+
+                                if ( m_sz == 0 && m_stp ) {
+                                    m_drnd.wakeAll ();
+                                    return;
+                                }
+
+                                for ( ; m_sz > 0; m_sz-- ) {
+                                    l_btch << m_rng[m_hd];
+                                    m_rng[m_hd].m_txt.clear ();
+                                    m_hd = ( m_hd + 1 ) % Capacity;
+                                }
+
+                                qSwap ( l_unrprtd, m_unrprtd );
+                                m_bsy = true;
+                            }
+
+                            if ( l_unrprtd > 0 )
+                                fprintf ( stderr, "(ling) [Log] Dropped %llu line(s).\n", l_unrprtd );
+
+                            foreach ( const LogEntry& l_entry, l_btch ) {
+                                const bool l_lbld = l_entry.m_lvl >= WNTRLING_LOG_WARNING;
+                                fprintf ( stderr, "(ling) [%s] %s%s%s\n", l_entry.m_cmp,
+                                          l_lbld ? s_lvlNms[l_entry.m_lvl] : "", l_lbld ? ": " : "",
+                                          l_entry.m_txt.trimmed ().toLocal8Bit ().constData () );
+                            }
+
+                            fflush ( stderr );
+
+                            QMutexLocker l_lckr ( &m_lck );
+                            m_bsy = false;
+                        }
+                    }
+
+                private:
+                    QVector<LogEntry> m_rng;
+                    int m_hd;
+                    int m_sz;
+                    qulonglong m_drpd;
+                    qulonglong m_unrprtd;
+                    bool m_bsy;
+                    bool m_stp;
+                    QMutex m_lck;
+                    QWaitCondition m_wk;
+                    QWaitCondition m_drnd;
+            };
+
+            LogRing& ring() {
+                static LogRing s_rng;
+                return s_rng;
+            }
+        }
+
+        const bool Log::isEnabled ( const Level& p_lvl ) {
+            return p_lvl >= (int) s_lvl;
+        }
+
+        const Log::Level Log::level() {
+            return (Level) (int) s_lvl;
+        }
+
+        void Log::setLevel ( const Level& p_lvl ) {
+            s_lvl = qMax ( (int) p_lvl, WNTRLING_LOG_LEVEL );
+        }
+
+        void Log::write ( const Level& p_lvl, const char* p_cmp, const QString& p_txt ) {
+            ring ().push ( p_lvl, p_cmp, p_txt );
+        }
+
+        void Log::flush() {
+            ring ().flush ();
+        }
+
+        const qulonglong Log::dropped() {
+            return ring ().dropped ();
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,169 @@
+/**
+ * @file    logging.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 19, 2026 2:20 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __LOGGING_HPP__
+#define __LOGGING_HPP__
+
+#include <QDebug>
+#include <QString>
+
+#define WNTRLING_LOG_TRACE 0
+#define WNTRLING_LOG_DEBUG 1
+#define WNTRLING_LOG_INFO 2
+#define WNTRLING_LOG_WARNING 3
+#define WNTRLING_LOG_ERROR 4
+
+/**
+ * @brief The lowest level of log line compiled in.
+ *
+ * Lines below it cost nothing at run time: their arguments are still compiled,
+ * but sit behind a constant false test and are eliminated as dead code.
+ * Release builds (QT_NO_DEBUG) keep informational lines and up, others keep
+ * debugging lines and up. Define it on the command line to override.
+ */
+#ifndef WNTRLING_LOG_LEVEL
+#  ifdef QT_NO_DEBUG
+#    define WNTRLING_LOG_LEVEL WNTRLING_LOG_INFO
+#  else
+#    define WNTRLING_LOG_LEVEL WNTRLING_LOG_DEBUG
+#  endif
+#endif
+
+#define WNTRLING_LOG(p_thrs, p_lvl, p_cmp) \
+    if ( p_thrs < WNTRLING_LOG_LEVEL || !Wintermute::Linguistics::Log::isEnabled ( Wintermute::Linguistics::Log::p_lvl ) ) ; \
+    else Wintermute::Linguistics::LogLine ( Wintermute::Linguistics::Log::p_lvl, p_cmp )
+
+/**
+ * @brief Streams a log line for a component, as in lingDebug ( "Parser" ) << "Found" << l_cnt << "path(s).";
+ *
+ * Nothing after the macro is evaluated unless the level is compiled in and
+ * enabled, so arguments can be as costly to format as need be.
+ */
+#define lingTrace(p_cmp) WNTRLING_LOG ( WNTRLING_LOG_TRACE, Trace, p_cmp )
+#define lingDebug(p_cmp) WNTRLING_LOG ( WNTRLING_LOG_DEBUG, Debug, p_cmp )
+#define lingInfo(p_cmp) WNTRLING_LOG ( WNTRLING_LOG_INFO, Info, p_cmp )
+#define lingWarning(p_cmp) WNTRLING_LOG ( WNTRLING_LOG_WARNING, Warning, p_cmp )
+#define lingError(p_cmp) WNTRLING_LOG ( WNTRLING_LOG_ERROR, Error, p_cmp )
+
+namespace Wintermute {
+    namespace Linguistics {
+        /**
+         * @brief Collects log lines in a ring buffer written out by a thread of its own.
+         *
+         * Logging a line only formats it and queues it; it's written to standard error
+         * later, so the thread logging it never waits on the terminal. When lines come
+         * faster than they can be written, the oldest queued lines are dropped and the
+         * drop is reported once the writer catches up.
+         *
+         * Use the lingTrace(), lingDebug(), lingInfo(), lingWarning() and lingError()
+         * macros rather than this class.
+         *
+         * @class Log logging.hpp "src/logging.hpp"
+         */
+        class Log {
+            public:
+                /**
+                 * @brief The levels of log lines.
+                 * @enum Level
+                 */
+                enum Level {
+                    Trace = WNTRLING_LOG_TRACE, /**< Step-by-step detail of the parse. */
+                    Debug = WNTRLING_LOG_DEBUG, /**< Detail of interest while debugging. */
+                    Info = WNTRLING_LOG_INFO, /**< Noteworthy events. */
+                    Warning = WNTRLING_LOG_WARNING, /**< Something's off, but work goes on. */
+                    Error = WNTRLING_LOG_ERROR /**< Something failed. */
+                };
+
+                /**
+                 * @brief Determines if lines of a level are logged at run time.
+                 * @fn isEnabled
+                 * @param p_lvl The level in question.
+                 */
+                static const bool isEnabled ( const Level& );
+
+                /**
+                 * @brief Obtains the lowest level logged at run time.
+                 * @fn level
+                 */
+                static const Level level();
+
+                /**
+                 * @brief Changes the lowest level logged at run time.
+                 *
+                 * Lines below WNTRLING_LOG_LEVEL stay out whatever the level.
+                 *
+                 * @fn setLevel
+                 * @param p_lvl The new level.
+                 */
+                static void setLevel ( const Level& );
+
+                /**
+                 * @brief Queues a line.
+                 * @fn write
+                 * @param p_lvl The level of the line.
+                 * @param p_cmp The component logging the line.
+                 * @param p_txt The text of the line.
+                 */
+                static void write ( const Level&, const char*, const QString& );
+
+                /**
+                 * @brief Waits for every queued line to be written.
+                 * @fn flush
+                 */
+                static void flush();
+
+                /**
+                 * @brief Obtains the number of lines dropped so far.
+                 * @fn dropped
+                 */
+                static const qulonglong dropped();
+        };
+
+        /**
+         * @brief Formats one log line and queues it with Log once it goes out of scope.
+         * @class LogLine logging.hpp "src/logging.hpp"
+         */
+        class LogLine {
+            Q_DISABLE_COPY(LogLine)
+
+            public:
+                LogLine ( const Log::Level& p_lvl, const char* p_cmp ) : m_lvl ( p_lvl ), m_cmp ( p_cmp ), m_dbg ( new QDebug ( &m_txt ) ) { }
+
+                ~LogLine() {
+                    delete m_dbg;
+                    Log::write ( m_lvl, m_cmp, m_txt );
+                }
+
+                template<typename T>
+                inline LogLine& operator<< ( const T& p_vl ) { *m_dbg << p_vl; return *this; }
+
+            private:
+                const Log::Level m_lvl;
+                const char* m_cmp;
+                QString m_txt;
+                QDebug* m_dbg;
+        };
+    }
+}
+
+#endif /* __LOGGING_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
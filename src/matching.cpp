@@ -0,0 +1,192 @@
+/**
+ * @file    matching.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 5:20 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "matching.hpp"
+#include <cstring>
+#include <QtDebug>
+#include <QStringList>
+#include <data/wntrdata.hpp>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WNTRLING_MATCHING_X86
+#include <immintrin.h>
+#endif
+
+namespace Wintermute {
+    namespace Linguistics {
+        namespace {
+            typedef int ( *PrefixFunction ) ( const char*, const char* );
+
+            /// Obtains the number of leading bytes two packed codes share.
+            int scalarPrefix ( const char* p_a, const char* p_b ) {
+                int l_i = 0;
+                while ( l_i < TypeCode::Width && p_a[l_i] == p_b[l_i] )
+                    l_i++;
+
+                return l_i;
+            }
+
+#ifdef WNTRLING_MATCHING_X86
+            __attribute__((target("sse2")))
+            int sse2Prefix ( const char* p_a, const char* p_b ) {
+                const __m128i l_lo = _mm_cmpeq_epi8 ( _mm_loadu_si128 ( reinterpret_cast<const __m128i*> ( p_a ) ),
+                                                      _mm_loadu_si128 ( reinterpret_cast<const __m128i*> ( p_b ) ) );
+                unsigned int l_msk = ~static_cast<unsigned int> ( _mm_movemask_epi8 ( l_lo ) ) & 0xFFFFu;
+                if ( l_msk )
+                    return __builtin_ctz ( l_msk );
+
+                const __m128i l_hi = _mm_cmpeq_epi8 ( _mm_loadu_si128 ( reinterpret_cast<const __m128i*> ( p_a + 16 ) ),
+                                                      _mm_loadu_si128 ( reinterpret_cast<const __m128i*> ( p_b + 16 ) ) );
+                l_msk = ~static_cast<unsigned int> ( _mm_movemask_epi8 ( l_hi ) ) & 0xFFFFu;
+                return l_msk ? 16 + __builtin_ctz ( l_msk ) : TypeCode::Width;
+            }
+
+            __attribute__((target("avx2")))
+            int avx2Prefix ( const char* p_a, const char* p_b ) {
+                const __m256i l_eq = _mm256_cmpeq_epi8 ( _mm256_loadu_si256 ( reinterpret_cast<const __m256i*> ( p_a ) ),
+                                                         _mm256_loadu_si256 ( reinterpret_cast<const __m256i*> ( p_b ) ) );
+                const unsigned int l_msk = ~static_cast<unsigned int> ( _mm256_movemask_epi8 ( l_eq ) );
+                return l_msk ? __builtin_ctz ( l_msk ) : TypeCode::Width;
+            }
+#endif
+
+            struct PrefixBackend {
+                PrefixFunction m_fn;
+                const char* m_nm;
+            };
+
+            PrefixBackend selectBackend() {
+                PrefixBackend l_bknd = { &scalarPrefix, "scalar" };
+#ifdef WNTRLING_MATCHING_X86
+                __builtin_cpu_init ();
+                if ( __builtin_cpu_supports ( "avx2" ) ) {
+                    l_bknd.m_fn = &avx2Prefix;
+                    l_bknd.m_nm = "avx2";
+                } else if ( __builtin_cpu_supports ( "sse2" ) ) {
+                    l_bknd.m_fn = &sse2Prefix;
+                    l_bknd.m_nm = "sse2";
+                }
+#endif
+                return l_bknd;
+            }
+
+            const PrefixBackend s_bknd = selectBackend ();
+
+            /// Converts a common prefix into a score, relative to the option's length.
+            inline double score ( const int p_prfx, const int p_qryLen, const int p_optLen ) {
+                if ( p_qryLen == 0 || p_optLen == 0 )
+                    return 0.0;
+
+                const int l_len = qMin ( p_prfx, qMin ( p_qryLen, p_optLen ) );
+                return ( l_len == 0 ) ? 0.0 : ( double ) l_len / ( double ) p_optLen;
+            }
+        }
+
+        TypeCode::TypeCode() : m_pckd(true), m_str() {
+            memset ( m_data, 0, Width );
+        }
+
+        TypeCode::TypeCode ( const QString& p_str ) : m_pckd(false), m_str(p_str) {
+            memset ( m_data, 0, Width );
+
+            if ( p_str.length () > Width )
+                return;
+
+            for ( int l_i = 0; l_i < p_str.length (); l_i++ ) {
+                const ushort l_uc = p_str.at ( l_i ).unicode ();
+                if ( l_uc == 0 || l_uc > 0xFF )
+                    return;
+
+                m_data[l_i] = static_cast<char> ( l_uc );
+            }
+
+            m_pckd = true;
+        }
+
+        const double TypeMatcher::scalarMatches ( const QString& p_query, const QString& p_option ) {
+            const int l_max = qMin ( p_query.length (), p_option.length () );
+            int l_prfx = 0;
+
+            while ( l_prfx < l_max && p_query.at ( l_prfx ) == p_option.at ( l_prfx ) )
+                l_prfx++;
+
+            return score ( l_prfx, p_query.length (), p_option.length () );
+        }
+
+        const double TypeMatcher::matches ( const TypeCode& p_query, const TypeCode& p_option ) {
+            if ( !p_query.isPacked () || !p_option.isPacked () )
+                return scalarMatches ( p_query.toString (), p_option.toString () );
+
+            const double l_rtn = score ( s_bknd.m_fn ( p_query.data (), p_option.data () ),
+                                         p_query.length (), p_option.length () );
+
+            Q_ASSERT ( l_rtn == Rules::Bond::matches ( p_query.toString (), p_option.toString () ) );
+            return l_rtn;
+        }
+
+        const double TypeMatcher::matches ( const TypeCode& p_query, const TypeCodeList& p_pattern ) {
+            double l_rtn = 0.0;
+
+            foreach ( const TypeCode& l_opt, p_pattern ) {
+                const double l_vl = matches ( p_query, l_opt );
+                if ( l_vl > l_rtn )
+                    l_rtn = l_vl;
+            }
+
+#ifndef QT_NO_DEBUG
+            QStringList l_opts;
+            foreach ( const TypeCode& l_opt, p_pattern )
+                l_opts << l_opt.toString ();
+
+            Q_ASSERT ( l_rtn == Rules::Bond::matches ( p_query.toString (), l_opts.join ( "," ) ) );
+#endif
+            return l_rtn;
+        }
+
+        /// One-off patterns aren't worth packing; they're scored on the scalar path as they stand.
+        const double TypeMatcher::matches ( const QString& p_query, const QString& p_pattern ) {
+            double l_rtn = 0.0;
+
+            foreach ( const QString& l_opt, p_pattern.split ( "," ) ) {
+                const double l_vl = scalarMatches ( p_query, l_opt );
+                if ( l_vl > l_rtn )
+                    l_rtn = l_vl;
+            }
+
+            Q_ASSERT ( l_rtn == Rules::Bond::matches ( p_query, p_pattern ) );
+            return l_rtn;
+        }
+
+        const TypeCodeList TypeMatcher::pack ( const QString& p_pattern ) {
+            TypeCodeList l_cds;
+
+            foreach ( const QString& l_opt, p_pattern.split ( "," ) )
+                l_cds << TypeCode ( l_opt );
+
+            return l_cds;
+        }
+
+        const char* TypeMatcher::backend() { return s_bknd.m_nm; }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
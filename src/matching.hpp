@@ -0,0 +1,178 @@
+/**
+ * @file    matching.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 5:20 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __MATCHING_HPP__
+#define __MATCHING_HPP__
+
+#include <QString>
+#include <QVector>
+
+namespace Wintermute {
+    namespace Linguistics {
+        class TypeCode;
+        class TypeMatcher;
+
+        /**
+         * @brief Represents a QVector of TypeCode objects.
+         * @see TypeMatcher::pack()
+         * @typedef TypeCodeList
+         */
+        typedef QVector<TypeCode> TypeCodeList;
+
+        /**
+         * @brief Represents a type string packed into a fixed-width, zero-padded byte code.
+         *
+         * The types of Node objects (the value of their first flag, as given by
+         * Node::toString(Node::EXTRA)) and the options of a Rules::Bond are short
+         * ASCII strings. Packing them once into a fixed-width buffer allows the
+         * TypeMatcher to compare them a whole register at a time.
+         *
+         * Strings that are too long or that aren't representable in Latin-1 are
+         * kept unpacked; the TypeMatcher falls back to its scalar path for them.
+         *
+         * @class TypeCode matching.hpp "src/matching.hpp"
+         */
+        class TypeCode {
+            public:
+                /**
+                 * @brief The width, in bytes, of a packed code.
+                 * @enum Width
+                 */
+                enum { Width = 32 };
+
+                /**
+                 * @brief Null constructor.
+                 * @fn TypeCode
+                 */
+                TypeCode();
+
+                /**
+                 * @brief Default constructor.
+                 * @fn TypeCode
+                 * @param p_str The type string to be packed.
+                 */
+                explicit TypeCode ( const QString& );
+
+                /**
+                 * @brief Obtains the length of the original type string.
+                 * @fn length
+                 */
+                inline const int length() const { return m_str.length (); }
+
+                /**
+                 * @brief Determines if the type string fit into a packed code.
+                 * @fn isPacked
+                 */
+                inline const bool isPacked() const { return m_pckd; }
+
+                /**
+                 * @brief Obtains the packed, zero-padded bytes of this code.
+                 * @fn data
+                 */
+                inline const char* data() const { return m_data; }
+
+                /**
+                 * @brief Obtains the type string this code was packed from.
+                 * @fn toString
+                 */
+                inline const QString& toString() const { return m_str; }
+
+            private:
+                char m_data[Width];
+                bool m_pckd;
+                QString m_str;
+        };
+
+        /**
+         * @brief Scores how well a Node's type satisfies a type pattern.
+         *
+         * This is the linguistics-side equivalent of Rules::Bond::matches(), used
+         * by Rule::appliesFor() and Binding::canBind(). A pattern is a comma-separated
+         * list of options; the score of a query against a pattern is the best score of
+         * the query against any one of its options. An option scores zero unless
+         * it shares its first character with the query; otherwise it scores the length
+         * of the common prefix over the length of the option.
+         *
+         * Packed codes are compared with SSE2 or AVX2 byte comparisons, picked at
+         * load-time by CPU feature detection. Debug builds check every score against
+         * Rules::Bond::matches(), the matcher this one replaces.
+         *
+         * @class TypeMatcher matching.hpp "src/matching.hpp"
+         */
+        class TypeMatcher {
+            public:
+                /**
+                 * @brief Scores a type string against a type pattern.
+                 *
+                 * Neither string is packed; use the TypeCode overloads for patterns that are
+                 * scored more than once.
+                 *
+                 * @fn matches
+                 * @param p_query The type of the Node in question.
+                 * @param p_pattern The comma-separated pattern.
+                 * @return A score from 0.0 (no match) to 1.0 (full match).
+                 */
+                static const double matches ( const QString&, const QString& );
+
+                /**
+                 * @brief Scores a packed type against one packed option.
+                 * @fn matches
+                 * @param p_query The packed type of the Node in question.
+                 * @param p_option The packed option.
+                 */
+                static const double matches ( const TypeCode&, const TypeCode& );
+
+                /**
+                 * @brief Scores a packed type against a packed pattern.
+                 * @fn matches
+                 * @param p_query The packed type of the Node in question.
+                 * @param p_pattern The pattern, as returned by pack().
+                 */
+                static const double matches ( const TypeCode&, const TypeCodeList& );
+
+                /**
+                 * @brief Splits a comma-separated pattern into its packed options.
+                 * @fn pack
+                 * @param p_pattern The pattern to be packed.
+                 */
+                static const TypeCodeList pack ( const QString& );
+
+                /**
+                 * @brief The reference, character-by-character scoring path.
+                 * @fn scalarMatches
+                 * @param p_query The type of the Node in question.
+                 * @param p_option A single option of a pattern.
+                 */
+                static const double scalarMatches ( const QString&, const QString& );
+
+                /**
+                 * @brief Obtains the name of the comparison path picked for this CPU.
+                 * @fn backend
+                 * @return One of "avx2", "sse2" or "scalar".
+                 */
+                static const char* backend();
+        };
+    }
+}
+
+#endif /* __MATCHING_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -20,11 +20,12 @@
  * @endlegalese
  */
 
-#include <iomanip>
-#include <iostream>
 #include "syntax.hpp"
 #include "parser.hpp"
 #include "meanings.hpp"
+#include "arena.hpp"
+#include "context.hpp"
+#include "logging.hpp"
 #include <plugins/data/ontology.hpp>
 
 using namespace std;
@@ -32,7 +33,12 @@ using namespace Wintermute::Linguistics;
 
 namespace Wintermute {
     namespace Linguistics {
-        int Meaning::s_cnt = 0;
+        namespace {
+            /// The interned names of the attributes that steer Meaning::form().
+            const Atom s_hide = Atoms::intern ( "hide" ), s_hideNext = Atoms::intern ( "hideNext" ),
+                       s_skipWord = Atoms::intern ( "skipWord" ), s_hideFilter = Atoms::intern ( "hideFilter" );
+        }
+
         Meaning::Meaning() { }
 
         Meaning::Meaning(const LinkList &p_lnkVtr) : m_lnkVtr(p_lnkVtr) {
@@ -51,7 +57,79 @@ namespace Wintermute {
                 m_ontoMap.insert(l_nd,l_lnk);
             }
 
-            qDebug() << "(ling) [Meaning] Encapsulates" << m_ontoMap.uniqueKeys ();
+            freeze();
+            lingTrace ( "Meaning" ) << "Encapsulates" << m_ontoMap.uniqueKeys ();
+        }
+
+        void Meaning::freeze() {
+            const int l_lnkCnt = m_lnkVtr.size ();
+            QVector<int> l_src ( l_lnkCnt ), l_dst ( l_lnkCnt );
+            int l_lvls = 0;
+
+            m_ndIdx.clear ();
+
+            // Give every Node a dense index, in the order they're first met.
+            for ( int l_i = 0; l_i < l_lnkCnt; l_i++ ) {
+                const Link* l_lnk = m_lnkVtr.at ( l_i );
+                const Node* l_nds[2] = { l_lnk->source (), l_lnk->destination () };
+                int* l_idxs[2] = { &l_src[l_i], &l_dst[l_i] };
+
+                for ( int l_j = 0; l_j < 2; l_j++ ) {
+                    QHash<const Node*, int>::ConstIterator l_itr = m_ndIdx.constFind ( l_nds[l_j] );
+                    if ( l_itr == m_ndIdx.constEnd () )
+                        l_itr = m_ndIdx.insert ( l_nds[l_j], m_ndIdx.size () );
+
+                    *l_idxs[l_j] = l_itr.value ();
+                }
+
+                l_lvls = qMax ( l_lvls, l_lnk->level () );
+            }
+
+            const int l_ndCnt = m_ndIdx.size ();
+            m_fwdOfs.fill ( 0, l_ndCnt + 1 );
+            m_revOfs.fill ( 0, l_ndCnt + 1 );
+            m_lvlOfs.fill ( 0, l_lvls + 2 );
+
+            for ( int l_i = 0; l_i < l_lnkCnt; l_i++ ) {
+                m_fwdOfs[l_src.at ( l_i ) + 1]++;
+                m_revOfs[l_dst.at ( l_i ) + 1]++;
+                m_lvlOfs[qMax ( 0, m_lnkVtr.at ( l_i )->level () ) + 1]++;
+            }
+
+            for ( int l_i = 1; l_i < m_fwdOfs.size (); l_i++ ) {
+                m_fwdOfs[l_i] += m_fwdOfs.at ( l_i - 1 );
+                m_revOfs[l_i] += m_revOfs.at ( l_i - 1 );
+            }
+
+            for ( int l_i = 1; l_i < m_lvlOfs.size (); l_i++ )
+                m_lvlOfs[l_i] += m_lvlOfs.at ( l_i - 1 );
+
+            // Scatter the Link objects into their rows; each row keeps the order of formation.
+            QVector<int> l_fwdPos ( m_fwdOfs ), l_revPos ( m_revOfs ), l_lvlPos ( m_lvlOfs );
+            m_fwdLnks.resize ( l_lnkCnt );
+            m_revLnks.resize ( l_lnkCnt );
+            m_lvlLnks.resize ( l_lnkCnt );
+
+            for ( int l_i = 0; l_i < l_lnkCnt; l_i++ ) {
+                Link* l_lnk = m_lnkVtr.at ( l_i );
+                m_fwdLnks[l_fwdPos[l_src.at ( l_i )]++] = l_lnk;
+                m_revLnks[l_revPos[l_dst.at ( l_i )]++] = l_lnk;
+                m_lvlLnks[l_lvlPos[qMax ( 0, l_lnk->level () )]++] = l_lnk;
+            }
+        }
+
+        const LinkList Meaning::slice ( const QVector<Link*>& p_lnks, const QVector<int>& p_ofs, const int& p_row ) {
+            LinkList l_lnkVtr;
+            if ( p_row < 0 || p_row + 1 >= p_ofs.size () )
+                return l_lnkVtr;
+
+            const int l_end = p_ofs.at ( p_row + 1 );
+            l_lnkVtr.reserve ( l_end - p_ofs.at ( p_row ) );
+
+            for ( int l_i = p_ofs.at ( p_row ); l_i < l_end; l_i++ )
+                l_lnkVtr << p_lnks.at ( l_i );
+
+            return l_lnkVtr;
         }
 
         /// @todo Should a pointer to the end iterator be passed? It'd reduce the need to constantly call the method but increases the size of the signature of the mention.
@@ -71,63 +149,88 @@ namespace Wintermute {
             }
         }
 
-        const Meaning* Meaning::form ( LinkList* p_lnkLst, const NodeList& p_ndVtr ) {
-            Meaning::s_cnt++;
-            if (p_lnkLst == NULL)
-                p_lnkLst = new LinkList;
+        const Meaning* Meaning::form ( const NodeList& p_ndVtr, ParseContext& p_ctx ) {
+            LinkList* l_lnkLst = p_ctx.arena ()->create<LinkList> ();
+            p_ctx.m_rnd = p_ndVtr;
+
+            for ( p_ctx.m_lvl = 1; ; p_ctx.m_lvl++ ) {
+                // A Meaning left half-linked is of no use to anyone; abandon the whole path.
+                if ( p_ctx.hasExpired () )
+                    return NULL;
 
-            cout << endl << setw(6) << setfill('=') << '=';
-            cout << " Level ";
-            cout << setw(4) << setfill('0') << right << s_cnt << ' ';
-            cout << setw(6) << setfill('=') << '=' << endl;
+                if ( p_ctx.m_lvl > p_ctx.maxLevels () ) {
+                    lingWarning ( "Meaning" ) << "Gave up on a path still unlinked after" << p_ctx.maxLevels () << "rounds.";
+                    return NULL;
+                }
+
+                formRound ( p_ctx, l_lnkLst );
 
-            NodeList::ConstIterator l_ndItr = p_ndVtr.begin ();
-            NodeList l_ndLst;
-            QStringList* l_hideList = NULL;
-            bool l_hideOther = false, l_hideThis = false;
+                if ( l_lnkLst->empty () )
+                    return NULL;
 
-            if (p_ndVtr.size () != 1) {                
+                if ( p_ctx.m_nxtRnd.isEmpty () )
+                    return p_ctx.arena ()->create<Meaning> ( *l_lnkLst );
+
+                qSwap ( p_ctx.m_rnd, p_ctx.m_nxtRnd );
+            }
+        }
+
+        void Meaning::formRound ( ParseContext& p_ctx, LinkList* p_lnkLst ) {
+            const NodeList& l_ndVtr = p_ctx.m_rnd;
+            NodeList& l_ndLst = p_ctx.m_nxtRnd;
+            QStringList& l_hideList = p_ctx.m_hdLst;
+            bool& l_hideOther = p_ctx.m_hdOthr;
+            bool& l_hideThis = p_ctx.m_hdThs;
+            Arena* l_arn = p_ctx.arena ();
+            p_ctx.beginRound ();
+
+            lingTrace ( "Meaning" ) << "Level" << p_ctx.level () << "with" << l_ndVtr.size () << "node(s).";
+
+            NodeList::ConstIterator l_ndItr = l_ndVtr.begin ();
+
+            if (l_ndVtr.size () != 1) {                
                 const Node *l_ndLeft;
                 const Node *l_ndRight;
-                const NodeList::ConstIterator l_ndItrEnd = p_ndVtr.end ();
+                const NodeList::ConstIterator l_ndItrEnd = l_ndVtr.end ();
 
                 for ( ; l_ndItr != l_ndItrEnd; l_ndItr++ ) {
-                    alignNodes(&p_ndVtr,l_ndLeft,l_ndRight,&l_ndLst,&l_ndItr);
+                    alignNodes(&l_ndVtr,l_ndLeft,l_ndRight,&l_ndLst,&l_ndItr);
 
-                    if (l_hideList) {
+                    if (!l_hideList.isEmpty ()) {
                         const QString l_k = l_ndLeft->toString (Node::EXTRA);
                         bool l_b = false;
-                        foreach (const QString l_s, *l_hideList)
+                        foreach (const QString l_s, l_hideList)
                             if (l_k.contains (l_s)) l_b = true;
 
                         if (!l_b) {
                             //qDebug() << "(ling) [Meaning] *** This node broke the filter; may appear on next round." << endl;
-                            l_hideList = NULL;
+                            l_hideList.clear ();
                             l_hideThis = false;
                         }
                         else {
                             l_hideThis = true;
-                            //qDebug() << "(ling) [Meaning] *** Node won't appear in next round due to filter '" << l_hideList->join (",") << "'." << endl;
+                            //qDebug() << "(ling) [Meaning] *** Node won't appear in next round due to filter '" << l_hideList.join (",") << "'." << endl;
                         }
                     }
 
-                    qDebug() << "(ling) [Meaning] Current node: " << l_ndLeft;
+                    lingTrace ( "Meaning" ) << "Current node:" << l_ndLeft;
 
-                    const Binding* l_bnd = Binding::obtain ( *l_ndLeft,*l_ndRight );
+                    const BindingDecision l_dcsn = Binding::obtain ( *l_ndLeft,*l_ndRight );
                     const Link* l_lnk;
-                    if ( l_bnd ) {
-                        l_lnk = l_bnd->bind ( *l_ndLeft,*l_ndRight );
-                        l_lnk->m_lvl = Meaning::s_cnt;
+                    if ( l_dcsn.isValid () ) {
+                        const Binding* l_bnd = l_dcsn.binding ();
+                        l_lnk = l_bnd->bind ( l_dcsn, l_arn );
+                        l_lnk->m_lvl = p_ctx.level ();
                         p_lnkLst->push_back ( const_cast<Link*>(l_lnk) );
 
-                        QString l_hide = l_bnd->getAttrValue("hide");
-                        QString l_hideNext = l_bnd->getAttrValue("hideNext");
-                        QString l_skipWord = l_bnd->getAttrValue("skipWord");
-                        QString l_hideFilter = l_bnd->getAttrValue ("hideFilter");
+                        QString l_hide = l_bnd->attribute ( s_hide );
+                        QString l_hideNext = l_bnd->attribute ( s_hideNext );
+                        QString l_skipWord = l_bnd->attribute ( s_skipWord );
+                        const QString l_hideFilter = l_bnd->attribute ( s_hideFilter );
 
-                        l_hide = (l_hide.isEmpty () || l_hide.isNull ()) ? "no" : l_hide;
-                        l_hideNext = (l_hideNext.isEmpty () || l_hideNext.isNull ()) ? "no" : l_hideNext;
-                        l_skipWord = (l_skipWord.isEmpty () || l_skipWord.isNull ()) ? "yes" : l_skipWord;
+                        l_hide = (l_hide.isEmpty ()) ? "no" : l_hide;
+                        l_hideNext = (l_hideNext.isEmpty ()) ? "no" : l_hideNext;
+                        l_skipWord = (l_skipWord.isEmpty ()) ? "yes" : l_skipWord;
 
                         // Attribute 'hide': Prevents this node (source node) from appearing on the next round of parsing. (default = 'no')
                         if ( !l_hideThis && !l_hideOther && l_hide == "no" )
@@ -151,17 +254,9 @@ namespace Wintermute {
 
 
                         // Attribute 'hideFilter': Hides a set of words from appearing on the next round of parsing; a wrapper for the 'hide' attribute. (default = "")
-                        if ( l_hideFilter.length () != 0 ) {
-                            QStringList *l_e = new QStringList;
-
-                            if ( l_hideFilter.contains ( "," ) ) {
-                                QStringList d = l_hideFilter.split ( "," );
-                                foreach ( const QString q, d )
-                                    l_e->append ( q );
-                            } else l_e->append ( l_hideFilter );
-
-                            l_hideList = l_e;
-                            //qDebug() << "(ling) [Meaning] *** Hiding any nodes that falls into the regex" << l_hideList->join (" 'or' ") << "on the next round.";
+                        if ( !l_hideFilter.isEmpty () ) {
+                            l_hideList = l_hideFilter.split ( "," );
+                            //qDebug() << "(ling) [Meaning] *** Hiding any nodes that falls into the regex" << l_hideList.join (" 'or' ") << "on the next round.";
                         }
         #if 0
                         qDebug() << "(ling) [Meaning] Flags> hide: (" << l_hide
@@ -170,7 +265,7 @@ namespace Wintermute {
                                  << ") hideNext: ("   << l_hideNext
                                  << ") hideFilter: (" << l_hideFilter
                                  << ") skipWord: ("   << l_skipWord
-                                 << ") hideList: ("   << ((l_hideList == NULL) ? "NULL" : "*") << ")"
+                                 << ") hideList: ("   << ((l_hideList.isEmpty ()) ? "NULL" : "*") << ")"
                                  << endl << "Link sig: " << l_lnk->toString ().c_str () << endl;
         #endif
 
@@ -182,20 +277,8 @@ namespace Wintermute {
                     //qDebug() << endl << "(ling) [Meaning] Nodes to be queued:" << endl << l_ndVtr << endl;
 
                 }
-                qDebug() << "(ling) [Meaning] Formed" << p_lnkLst->size () << "links with" << l_ndLst.size () << "nodes left to parse.";
+                lingDebug ( "Meaning" ) << "Formed" << p_lnkLst->size () << "links with" << l_ndLst.size () << "nodes left to parse.";
             }
-
-            if ( !p_lnkLst->empty () ) {
-                if ( ! ( p_lnkLst->size () >= 1) || l_ndLst.size () > 0 ){
-                    Q_ASSERT(Meaning::s_cnt < 5);
-                    return Meaning::form ( &*p_lnkLst, l_ndLst );
-                }
-                else {
-                    Meaning::s_cnt = 0;
-                    return new Meaning ( *p_lnkLst );
-                }
-            } else
-                return NULL;
         }
 
         const Link* Meaning::base () const {
@@ -206,67 +289,42 @@ namespace Wintermute {
             return &m_lnkVtr;
         }
 
-        const LinkList Meaning::linksAt(const int& p_lvl){
-            LinkList l_lnkVtr;
-
-            if (p_lvl > 1 && p_lvl <= levels()){
-                foreach (Link* l_lnk, m_lnkVtr){
-                    if (l_lnk->level() == p_lvl)
-                        l_lnkVtr << l_lnk;
-                    else continue;
-                }
-            } else
-                qDebug() << "(ling) [Meaning] Out of level range.";
+        const LinkList Meaning::linksAt(const int& p_lvl) const {
+            if (p_lvl >= 1 && p_lvl <= levels())
+                return slice ( m_lvlLnks, m_lvlOfs, p_lvl );
 
-            return l_lnkVtr;
+            lingDebug ( "Meaning" ) << "Out of level range.";
+            return LinkList();
         }
 
         const int Meaning::levels() const {
-            int l_lvl = 0;
-
-            foreach (const Link* l_lnk, m_lnkVtr){
-                if (l_lvl < l_lnk->level())
-                    l_lvl = l_lnk->level();
-                else continue;
-            }
-
-            return l_lvl;
+            return qMax ( 0, m_lvlOfs.size () - 2 );
         }
 
         const LinkList Meaning::isLinkedTo(const Node& p_nd) const {
-            LinkList l_lnkVtr;
-
-            foreach (Link* l_lnk, m_lnkVtr) {
-                if (l_lnk->source () == &p_nd)
-                    l_lnkVtr << l_lnk;
-            }
-
-            return l_lnkVtr;
+            return slice ( m_fwdLnks, m_fwdOfs, m_ndIdx.value ( &p_nd, -1 ) );
         }
 
         const LinkList Meaning::isLinkedBy(const Node& p_nd) const {
-            LinkList l_lnkVtr;
-
-            foreach (Link* l_lnk, m_lnkVtr) {
-                if (l_lnk->destination () == &p_nd)
-                    l_lnkVtr << l_lnk;
-            }
-
-            return l_lnkVtr;
+            return slice ( m_revLnks, m_revOfs, m_ndIdx.value ( &p_nd, -1 ) );
         }
 
         const QString Meaning::toText () const {
             if (levels() >= 2){
-                qDebug() << "(ling) [Meaning] Has" << m_lnkVtr.size () << "link(s).";
+                lingDebug ( "Meaning" ) << "Has" << m_lnkVtr.size () << "link(s).";
                 foreach (const Link* l_lnk, m_lnkVtr)
-                    qDebug() << "(ling) [Meaning]" << l_lnk;
+                    lingDebug ( "Meaning" ) << l_lnk;
             } else {
-                qDebug() << "(ling) [Meaning] Invalid meaning.";
+                lingDebug ( "Meaning" ) << "Invalid meaning.";
             }
 
             return QString::null;
         }
 
+        const QByteArray Meaning::toBinary () const {
+            return MeaningEncoding::encode ( *this );
+        }
+
         Meaning::~Meaning () { }
     }
 }
@@ -23,9 +23,13 @@
 #ifndef __MEANINGS_HPP__
 #define __MEANINGS_HPP__
 
+#include <QHash>
 #include <QObject>
+#include <QVector>
 #include <QMultiMap>
 #include "syntax.hpp"
+#include "context.hpp"
+#include "encoding.hpp"
 
 namespace Wintermute {
     namespace Linguistics {
@@ -68,12 +72,18 @@ namespace Wintermute {
      * and modify the linking process. This is where the conversion from natural text
      * to an intermediate form of ontological syntax is done.
      *
+     * Once formed, a Meaning freezes its Link objects into a compressed-sparse-row
+     * index: its Link objects ordered by source Node, by destination Node and by
+     * level, each with an offset table. isLinkedTo(), isLinkedBy() and linksAt()
+     * then only touch the Link objects they return.
+     *
      * @see Binding
      * @see Rule
      * @class Meaning parser.hpp "src/parser.hpp"
      */
     class Meaning : public QObject {
         Q_OBJECT
+        friend class MeaningEncoding;
 
         Q_PROPERTY(const Link* base READ base)
         Q_PROPERTY(const LinkList* siblings READ siblings)
@@ -124,6 +134,13 @@ namespace Wintermute {
              */
             const QString toText() const;
 
+            /**
+             * @brief Obtains the compact binary form of a Meaning.
+             * @fn toBinary
+             * @see MeaningEncoding, MeaningReader
+             */
+            const QByteArray toBinary() const;
+
             /**
              * @brief Obtains the number of levels in a Meaning.
              * @fn levels
@@ -135,7 +152,7 @@ namespace Wintermute {
              * @fn linksAt
              * @param p_lvl The level to get the Link objects at.
              */
-            const LinkList linksAt(const int& = 1);
+            const LinkList linksAt(const int& = 1) const;
 
             /**
              * @brief Obtains a LinkList of Link objects that of which the specified Node is the source.
@@ -154,12 +171,19 @@ namespace Wintermute {
             const LinkList isLinkedBy(const Node& ) const;
 
             /**
-             * @brief Forms a Meaning from a LinkList and a NodeList.
+             * @brief Forms a Meaning from a NodeList.
+             *
+             * The Node objects are linked in rounds; the Node objects left over by one
+             * round are linked in the next, until none are left. Everything is formed
+             * in the ParseContext's Arena, and each Link is given the level of the round
+             * that formed it.
+             *
              * @fn form
-             * @param p_lnkLst The list of Link objects.
              * @param p_nodeLst The list of Node objects.
+             * @param p_ctx The ParseContext of the parse; its CancelToken is checked before each round.
+             * @return The formed Meaning, or NULL if no Link was formed, the path took too many rounds or the token expired.
              */
-            static const Meaning* form ( LinkList* , const NodeList& );
+            static const Meaning* form ( const NodeList&, ParseContext& );
 
         protected:
             LinkList m_lnkVtr;
@@ -167,8 +191,17 @@ namespace Wintermute {
 
         private:
             void __init();
+            void freeze();
+            static const LinkList slice ( const QVector<Link*>&, const QVector<int>&, const int& );
+            QHash<const Node*, int> m_ndIdx;
+            QVector<int> m_fwdOfs;
+            QVector<Link*> m_fwdLnks;
+            QVector<int> m_revOfs;
+            QVector<Link*> m_revLnks;
+            QVector<int> m_lvlOfs;
+            QVector<Link*> m_lvlLnks;
+            static void formRound ( ParseContext&, LinkList* );
             static void alignNodes(const NodeList*, const Node*, const Node*, NodeList*, NodeList::ConstIterator*);
-            static int s_cnt;
         };
     }
 }
@@ -0,0 +1,208 @@
+/**
+ * @file    metrics.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 19, 2026 11:45 AM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "metrics.hpp"
+#include <QFile>
+#include <QTextStream>
+
+namespace Wintermute {
+    namespace Linguistics {
+        namespace {
+            const char* const s_stgNms[Metrics::StageCount] = {
+                "parse", "tokenize", "form_nodes", "expand_nodes", "form_meanings",
+                "node_exists", "node_read", "node_write", "node_pseudo", "node_batch",
+                "rule_read", "suffix_lookup"
+            };
+
+            const double s_qntls[3] = { 0.5, 0.99, 0.999 };
+            const char* const s_qntlNms[3] = { "p50", "p99", "p999" };
+        }
+
+        LatencyHistogram::LatencyHistogram() : m_max ( 0 ), m_sum ( 0 ) {
+            for ( int l_i = 0; l_i < Buckets; l_i++ )
+                m_bckts[l_i] = 0;
+        }
+
+        const int LatencyHistogram::bucketOf ( const qint64& p_usecs ) {
+            if ( p_usecs < SubBuckets )
+                return (int) qMax ( Q_INT64_C ( 0 ), p_usecs );
+
+            int l_exp = 3;
+            while ( l_exp < 30 && ( p_usecs >> ( l_exp + 1 ) ) != 0 )
+                l_exp++;
+
+            const int l_sub = (int) qMin ( Q_INT64_C ( 7 ), ( p_usecs >> ( l_exp - 3 ) ) - SubBuckets );
+            return ( l_exp - 2 ) * SubBuckets + l_sub;
+        }
+
+        const qint64 LatencyHistogram::upperBoundOf ( const int& p_bckt ) {
+            if ( p_bckt < SubBuckets )
+                return p_bckt + 1;
+
+            const int l_exp = p_bckt / SubBuckets + 2, l_sub = p_bckt % SubBuckets;
+            return (qint64) ( SubBuckets + l_sub + 1 ) << ( l_exp - 3 );
+        }
+
+        void LatencyHistogram::record ( const qint64& p_usecs ) {
+            const qint64 l_usecs = qBound ( Q_INT64_C ( 0 ), p_usecs, Q_INT64_C ( 0x7fffffff ) );
+            m_bckts[bucketOf ( l_usecs )].ref ();
+            __sync_fetch_and_add ( &m_sum, l_usecs );
+
+            for ( int l_max = m_max; l_usecs > l_max; l_max = m_max ) {
+                if ( m_max.testAndSetOrdered ( l_max, (int) l_usecs ) )
+                    break;
+            }
+        }
+
+        const qint64 LatencyHistogram::count() const {
+            qint64 l_cnt = 0;
+            for ( int l_i = 0; l_i < Buckets; l_i++ )
+                l_cnt += (int) m_bckts[l_i];
+
+            return l_cnt;
+        }
+
+        const qint64 LatencyHistogram::sum() const {
+            return __sync_fetch_and_add ( const_cast<qint64*> ( &m_sum ), 0 );
+        }
+
+        const qint64 LatencyHistogram::max() const {
+            return (int) m_max;
+        }
+
+        const qint64 LatencyHistogram::quantile ( const double& p_q ) const {
+            int l_cnts[Buckets];
+            qint64 l_ttl = 0;
+
+            for ( int l_i = 0; l_i < Buckets; l_i++ )
+                l_ttl += ( l_cnts[l_i] = m_bckts[l_i] );
+
+            if ( l_ttl == 0 )
+                return 0;
+
+            const qint64 l_rnk = qMax ( Q_INT64_C ( 1 ), (qint64) ( qBound ( 0.0, p_q, 1.0 ) * l_ttl + 0.999999 ) );
+            qint64 l_seen = 0;
+
+            for ( int l_i = 0; l_i < Buckets; l_i++ ) {
+                l_seen += l_cnts[l_i];
+                if ( l_seen >= l_rnk )
+                    return qMin ( upperBoundOf ( l_i ), max () );
+            }
+
+            return max ();
+        }
+
+        void LatencyHistogram::clear() {
+            for ( int l_i = 0; l_i < Buckets; l_i++ )
+                m_bckts[l_i] = 0;
+
+            m_max = 0;
+            __sync_lock_test_and_set ( &m_sum, 0 );
+        }
+
+        LatencyHistogram& Metrics::histogram ( const Stage& p_stg ) {
+            static LatencyHistogram s_hstgrms[StageCount];
+            return s_hstgrms[qBound ( 0, (int) p_stg, StageCount - 1 )];
+        }
+
+        const QString Metrics::nameOf ( const Stage& p_stg ) {
+            return QString::fromLatin1 ( s_stgNms[qBound ( 0, (int) p_stg, StageCount - 1 )] );
+        }
+
+        const QVariantMap Metrics::snapshot() {
+            QVariantMap l_snpsht;
+
+            for ( int l_i = 0; l_i < StageCount; l_i++ ) {
+                const LatencyHistogram& l_hstgrm = histogram ( (Stage) l_i );
+                QVariantMap l_stg;
+
+                l_stg.insert ( "count", l_hstgrm.count () );
+                l_stg.insert ( "sum", l_hstgrm.sum () );
+                for ( int l_j = 0; l_j < 3; l_j++ )
+                    l_stg.insert ( s_qntlNms[l_j], l_hstgrm.quantile ( s_qntls[l_j] ) );
+                l_stg.insert ( "max", l_hstgrm.max () );
+
+                l_snpsht.insert ( nameOf ( (Stage) l_i ), l_stg );
+            }
+
+            return l_snpsht;
+        }
+
+        const QString Metrics::toPrometheus() {
+            QString l_txt;
+            QTextStream l_strm ( &l_txt );
+
+            l_strm << "# HELP wntrling_stage_latency_seconds Latency of each parse stage and data service call.\n"
+                   << "# TYPE wntrling_stage_latency_seconds summary\n";
+
+            for ( int l_i = 0; l_i < StageCount; l_i++ ) {
+                const LatencyHistogram& l_hstgrm = histogram ( (Stage) l_i );
+                const QString l_lbl = QString ( "stage=\"%1\"" ).arg ( nameOf ( (Stage) l_i ) );
+
+                for ( int l_j = 0; l_j < 3; l_j++ )
+                    l_strm << "wntrling_stage_latency_seconds{" << l_lbl << ",quantile=\"" << s_qntls[l_j] << "\"} "
+                           << l_hstgrm.quantile ( s_qntls[l_j] ) / 1e6 << "\n";
+
+                l_strm << "wntrling_stage_latency_seconds_sum{" << l_lbl << "} " << l_hstgrm.sum () / 1e6 << "\n"
+                       << "wntrling_stage_latency_seconds_count{" << l_lbl << "} " << l_hstgrm.count () << "\n";
+            }
+
+            l_strm << "# HELP wntrling_stage_latency_max_seconds Longest latency of each parse stage and data service call.\n"
+                   << "# TYPE wntrling_stage_latency_max_seconds gauge\n";
+
+            for ( int l_i = 0; l_i < StageCount; l_i++ )
+                l_strm << "wntrling_stage_latency_max_seconds{stage=\"" << nameOf ( (Stage) l_i ) << "\"} "
+                       << histogram ( (Stage) l_i ).max () / 1e6 << "\n";
+
+            l_strm.flush ();
+            return l_txt;
+        }
+
+        const bool Metrics::dump ( const QString& p_pth ) {
+            // Write beside the file and rename over it, so a scraper never reads half a dump.
+            const QString l_tmpPth = p_pth + ".tmp";
+            QFile l_tmp ( l_tmpPth );
+
+            if ( !l_tmp.open ( QIODevice::WriteOnly | QIODevice::Truncate ) )
+                return false;
+
+            const QByteArray l_dt = toPrometheus ().toUtf8 ();
+            const bool l_wrttn = l_tmp.write ( l_dt ) == l_dt.size ();
+            l_tmp.close ();
+
+            if ( !l_wrttn ) {
+                QFile::remove ( l_tmpPth );
+                return false;
+            }
+
+            QFile::remove ( p_pth );
+            return QFile::rename ( l_tmpPth, p_pth );
+        }
+
+        void Metrics::clear() {
+            for ( int l_i = 0; l_i < StageCount; l_i++ )
+                histogram ( (Stage) l_i ).clear ();
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,208 @@
+/**
+ * @file    metrics.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 19, 2026 11:45 AM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __METRICS_HPP__
+#define __METRICS_HPP__
+
+#include <QString>
+#include <QAtomicInt>
+#include <QVariantMap>
+#include <QElapsedTimer>
+
+namespace Wintermute {
+    namespace Linguistics {
+        /**
+         * @brief Counts latencies into log-linear buckets.
+         *
+         * Each power of two of microseconds is split into eight buckets, so any
+         * quantile is known to within an eighth of its value, from 1µs up to about
+         * half an hour. Recording a latency is a handful of atomic operations and
+         * never takes a lock; reading quantiles walks a snapshot of the buckets.
+         *
+         * @class LatencyHistogram metrics.hpp "src/metrics.hpp"
+         */
+        class LatencyHistogram {
+            Q_DISABLE_COPY(LatencyHistogram)
+
+            public:
+                enum {
+                    SubBuckets = 8, /**< The buckets each power of two is split into. */
+                    Buckets = 232 /**< The buckets needed to cover latencies below 2^31µs. */
+                };
+
+                /**
+                 * @brief Null constructor.
+                 * @fn LatencyHistogram
+                 */
+                LatencyHistogram();
+
+                /**
+                 * @brief Counts a latency.
+                 * @fn record
+                 * @param p_usecs The latency, in microseconds.
+                 */
+                void record ( const qint64& );
+
+                /**
+                 * @brief Obtains the number of latencies counted.
+                 * @fn count
+                 */
+                const qint64 count() const;
+
+                /**
+                 * @brief Obtains the sum of the latencies counted, in microseconds.
+                 * @fn sum
+                 */
+                const qint64 sum() const;
+
+                /**
+                 * @brief Obtains the longest latency counted, in microseconds.
+                 * @fn max
+                 */
+                const qint64 max() const;
+
+                /**
+                 * @brief Obtains a quantile of the latencies counted, in microseconds.
+                 * @fn quantile
+                 * @param p_q The quantile, from 0.0 to 1.0.
+                 * @return The upper bound of the bucket holding the quantile (at most max()), or 0 if nothing was counted.
+                 */
+                const qint64 quantile ( const double& ) const;
+
+                /**
+                 * @brief Forgets every latency counted.
+                 * @fn clear
+                 */
+                void clear();
+
+            private:
+                static const int bucketOf ( const qint64& );
+                static const qint64 upperBoundOf ( const int& );
+                QAtomicInt m_bckts[Buckets];
+                QAtomicInt m_max;
+                qint64 m_sum;
+        };
+
+        /**
+         * @brief Keeps a LatencyHistogram for each stage of a parse and each call to the data service.
+         *
+         * The histograms are process-wide. A StageTimer is the easiest way to feed one.
+         *
+         * @class Metrics metrics.hpp "src/metrics.hpp"
+         */
+        class Metrics {
+            public:
+                /**
+                 * @brief Represents what's timed.
+                 * @enum Stage
+                 */
+                enum Stage {
+                    Parse = 0, /**< A whole call to Parser::parse(). */
+                    Tokenize, /**< Parser::getTokens(). */
+                    FormNodes, /**< Parser::formNodes(), lookups included. */
+                    ExpandNodes, /**< Parser::expandNodes(). */
+                    FormMeanings, /**< Forming the Meaning objects of a sentence's paths. */
+                    NodeExists, /**< The data service's exists() call. */
+                    NodeRead, /**< The data service's read() call for a Node. */
+                    NodeWrite, /**< The data service's write() call. */
+                    NodePseudo, /**< The data service's pseudo() call. */
+                    NodeBatch, /**< A Node::obtainAll() call. */
+                    RuleRead, /**< The data service's read() call for a rule. */
+                    SuffixLookup, /**< A full suffix lookup. */
+                    StageCount
+                };
+
+                /**
+                 * @brief Obtains the histogram of a stage.
+                 * @fn histogram
+                 * @param p_stg The stage.
+                 */
+                static LatencyHistogram& histogram ( const Stage& );
+
+                /**
+                 * @brief Obtains the name of a stage, as used in snapshot() and toPrometheus().
+                 * @fn nameOf
+                 * @param p_stg The stage.
+                 */
+                static const QString nameOf ( const Stage& );
+
+                /**
+                 * @brief Obtains the figures of every stage.
+                 *
+                 * The map has an entry per stage, itself a map of "count", and of "sum",
+                 * "p50", "p99", "p999" and "max" in microseconds.
+                 *
+                 * @fn snapshot
+                 */
+                static const QVariantMap snapshot();
+
+                /**
+                 * @brief Obtains the figures of every stage in the Prometheus text format.
+                 * @fn toPrometheus
+                 */
+                static const QString toPrometheus();
+
+                /**
+                 * @brief Writes toPrometheus() to a file, replacing it whole.
+                 * @fn dump
+                 * @param p_pth The path of the file.
+                 * @return true if the file was written.
+                 */
+                static const bool dump ( const QString& );
+
+                /**
+                 * @brief Forgets the figures of every stage.
+                 * @fn clear
+                 */
+                static void clear();
+        };
+
+        /**
+         * @brief Times a scope and records it in the histogram of a stage.
+         * @class StageTimer metrics.hpp "src/metrics.hpp"
+         */
+        class StageTimer {
+            Q_DISABLE_COPY(StageTimer)
+
+            public:
+                /**
+                 * @brief Starts timing.
+                 * @fn StageTimer
+                 * @param p_stg The stage being timed.
+                 */
+                explicit StageTimer ( const Metrics::Stage& p_stg ) : m_stg ( p_stg ) { m_tmr.start (); }
+
+                /**
+                 * @brief Records the time since construction.
+                 * @fn ~StageTimer
+                 */
+                ~StageTimer() { Metrics::histogram ( m_stg ).record ( m_tmr.nsecsElapsed () / 1000 ); }
+
+            private:
+                const Metrics::Stage m_stg;
+                QElapsedTimer m_tmr;
+        };
+    }
+}
+
+#endif /* __METRICS_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -24,13 +24,22 @@
 #include "parser.hpp"
 #include "meanings.hpp"
 #include "syntax.hpp"
-#include <iostream>
-#include <iomanip>
+#include "metrics.hpp"
+#include "logging.hpp"
+#include <algorithm>
 #include <QFile>
 #include <QString>
+#include <QSet>
 #include <QVector>
+#include <QtAlgorithms>
 #include <QtDebug>
 #include <QTextStream>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <QRunnable>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QThread>
 #include <data/wntrdata.hpp>
 #include <data/interfaces.hpp>
 #include <boost/tokenizer.hpp>
@@ -39,47 +48,96 @@ using namespace std;
 using namespace Wintermute::Data;
 using namespace Wintermute::Data::Linguistics;
 
-using std::cout;
-using std::endl;
 namespace Wintermute {
     namespace Linguistics {
-        Token::Token() : m_prfx(), m_sffx(), m_data() { }
-        Token::Token(const Token& p_tok) : m_prfx(p_tok.m_prfx), m_sffx(p_tok.m_sffx), m_data(p_tok.m_data) { }
-        Token::Token(const QString& p_tokStr) : m_prfx(), m_sffx(), m_data() { __init(p_tokStr); }
+        namespace {
+            /// Orders RatedBinding objects from the highest score to the lowest.
+            bool rankedHigher ( const RatedBinding& p_a, const RatedBinding& p_b ) {
+                return p_a.first > p_b.first;
+            }
 
-        /// @todo Implement a means of increasing the precision when dissecting strings.
-        void Token::__init(const QString& p_tokStr){
-            int mode = 0;
-            foreach (const QChar l_chr, p_tokStr){
-                switch (mode){
-                    case 0: {
-                        /// Prefix symbol
-                        if (!l_chr.isLetterOrNumber())
-                            m_prfx += l_chr;
-                        else {
-                            mode = 1;
-                            m_data += l_chr;
-                        }
-                    } break;
+            /// The attributes of a Bond consulted while linking; read once per Binding and kept by their interned names.
+            const char* const s_lnkAttrs[] = { "with", "has", "hasAll", "typeHas", "linkAction",
+                                               "hide", "hideNext", "skipWord", "hideFilter" };
 
-                    case 1: {
-                        /// Root symbol
-                        if (l_chr.isLetterOrNumber())
-                            m_data += l_chr;
-                        else {
-                            mode = 2;
-                            m_sffx += l_chr;
-                        }
-                    } break;
+            /// The least time between two announcements of progress, in milliseconds.
+            const qint64 s_prgIntrvl = 50;
 
-                    case 2: {
-                        /// Suffix symbol
-                        m_sffx += l_chr;
-                    } break;
+            /// The number of looked-up sentences that may wait to be linked.
+            const int s_stgDpth = 2;
+
+            typedef QPair<Atom, QString> RuleKey;
+            typedef QHash<RuleKey, QSharedPointer<const Rule> > RuleCache;
+
+            /// The Rule of every (locale, flag) read so far.
+            RuleCache s_rls;
+            QReadWriteLock s_rlLck;
+
+            /// The threads that look up sentences ahead of their linking.
+            QThreadPool* stagePool () {
+                static QThreadPool* s_pl = 0;
+                static QMutex s_lck;
+                QMutexLocker l_lck ( &s_lck );
+
+                if ( !s_pl ) {
+                    s_pl = new QThreadPool;
+                    s_pl->setMaxThreadCount ( qMax ( 2, QThread::idealThreadCount () ) );
                 }
+
+                return s_pl;
             }
+        }
 
-            //qDebug() << "Token:" << m_prfx << m_data << m_sffx;
+        /**
+         * @brief Looks up the sentences of a text, one after another, for Parser::parseStaged().
+         * @class LookupStage parser.cpp "src/parser.cpp"
+         */
+        class LookupStage : public QRunnable {
+            public:
+                LookupStage ( Parser* p_prs, ParseContext* p_ctx, const QString* p_txt, const SentenceList* p_sntncs, const int& p_cnt,
+                              const QVector<bool>* p_dn, StageQueue<StagedSentence>* p_q, QSemaphore* p_fnshd ) :
+                    m_prs ( p_prs ), m_ctx ( p_ctx ), m_txt ( p_txt ), m_sntncs ( p_sntncs ), m_cnt ( p_cnt ), m_dn ( p_dn ), m_q ( p_q ), m_fnshd ( p_fnshd ) { }
+
+                virtual void run () {
+                    for ( int l_i = 0; l_i < m_cnt && !m_ctx->hasExpired (); l_i++ ) {
+                        if ( m_dn->at ( l_i ) )
+                            continue;
+
+                        StagedSentence l_sntnc;
+                        l_sntnc.m_indx = l_i;
+                        m_prs->lookup ( *m_ctx, *m_txt, m_sntncs->at ( l_i ) );
+                        l_sntnc.m_vrnts = m_ctx->m_vrnts;
+                        l_sntnc.m_pths = m_ctx->m_pths;
+
+                        if ( !m_q->push ( l_sntnc ) )
+                            break;
+                    }
+
+                    m_q->close ();
+                    m_fnshd->release ();
+                }
+
+            private:
+                Parser* m_prs;
+                ParseContext* m_ctx;
+                const QString* m_txt;
+                const SentenceList* m_sntncs;
+                const int m_cnt;
+                const QVector<bool>* m_dn;
+                StageQueue<StagedSentence>* m_q;
+                QSemaphore* m_fnshd;
+        };
+
+        Token::Token() : m_prfx(), m_sffx(), m_data() { }
+        Token::Token(const Token& p_tok) : m_prfx(p_tok.m_prfx), m_sffx(p_tok.m_sffx), m_data(p_tok.m_data) { }
+        Token::Token(const QString& p_tokStr) : m_prfx(), m_sffx(), m_data() { __init(p_tokStr); }
+
+        /// @todo Implement a means of increasing the precision when dissecting strings.
+        void Token::__init(const QString& p_tokStr){
+            const TokenRange l_rng = TokenStore::dissect (p_tokStr, 0, p_tokStr.length ());
+            m_prfx = p_tokStr.left (l_rng.m_prfx);
+            m_data = p_tokStr.mid (l_rng.rootPosition (), l_rng.m_root);
+            m_sffx = p_tokStr.mid (l_rng.suffixPosition (), l_rng.m_sffx);
         }
 
         const QString Token::symbol() const { return m_data; }
@@ -88,74 +146,124 @@ namespace Wintermute {
 
         const TokenList Token::form(const QString& p_str) {
             TokenList l_tknLst;
-
-            foreach (const QString l_str, p_str.split(" "))
-                l_tknLst << new Token(l_str);
+            TokenStore l_str;
+            l_str.tokenize (p_str);
+
+            for (int l_i = 0; l_i < l_str.size (); l_i++){
+                Token* l_tkn = new Token;
+                l_tkn->m_prfx = l_str.prefix (l_i).toString ();
+                l_tkn->m_data = l_str.symbol (l_i).toString ();
+                l_tkn->m_sffx = l_str.suffix (l_i).toString ();
+                l_tknLst << l_tkn;
+            }
 
             return l_tknLst;
         }
 
-        Binding::Binding ( const Rules::Bond& p_bnd , const Rule* p_rl ) : m_bnd(p_bnd), m_rl(p_rl) { }
+        Binding::Binding ( const Rules::Bond& p_bnd , const Rule* p_rl ) : m_bnd(p_bnd), m_rl(p_rl) {
+            for ( unsigned int l_i = 0; l_i < sizeof ( s_lnkAttrs ) / sizeof ( s_lnkAttrs[0] ); l_i++ ) {
+                const QString l_attr = QString::fromLatin1 ( s_lnkAttrs[l_i] );
+                m_attrs.insert ( Atoms::intern ( l_attr ), m_bnd.attribute ( l_attr ) );
+            }
+
+            m_has = m_bnd.attribute ( "has" );
+            m_hasAll = m_bnd.attribute ( "hasAll" );
+            m_typHas = m_bnd.attribute ( "typeHas" );
+            m_chkTypHas = m_bnd.hasAttribute ( "typeHas" );
+            m_wthCds = TypeMatcher::pack ( m_bnd.attribute ( "with" ) );
+
+            foreach ( const TypeCode& l_cd, m_wthCds )
+                m_wthHasCds << TypeCode ( l_cd.toString ().left ( 1 ) + m_has );
+
+            const QStringList l_options = m_bnd.attribute ( "linkAction" ).split ( "," );
+            m_rvrs = l_options.contains ( "reverse" );
+            m_othrTyp = l_options.contains ( "othertype" );
+            m_thsTyp = l_options.contains ( "thistype" );
+        }
+
+        const BindingDecision Binding::obtain ( const Node& p_nd, const Node& p_nd2 ) {
+            const QSharedPointer<const Rule> l_rl = Rule::obtain ( p_nd );
+            if ( !l_rl ) return BindingDecision();
 
-        const Binding* Binding::obtain ( const Node& p_nd, const Node& p_nd2 ) {
-            const Rule* l_rl = Rule::obtain ( p_nd );
-            if ( !l_rl ) return NULL;
-            return l_rl->getBindingFor ( p_nd,p_nd2 );
+            BindingDecision l_dcsn = l_rl->getBindingFor ( p_nd,p_nd2 );
+            if ( l_dcsn.isValid () )
+                l_dcsn.m_rl = l_rl;
+
+            return l_dcsn;
         }
 
         const QString Binding::getAttrValue ( const QString &p_attr ) const {
+            Atom l_attr = 0;
+            if ( Atoms::lookup ( p_attr, l_attr ) )
+                return attribute ( l_attr );
+
             return m_bnd.attribute (p_attr);
         }
 
+        const QString Binding::attribute ( const Atom& p_attr ) const {
+            const QHash<Atom, QString>::ConstIterator l_itr = m_attrs.constFind ( p_attr );
+            if ( l_itr != m_attrs.constEnd () )
+                return l_itr.value ();
+
+            return m_bnd.attribute ( Atoms::toString ( p_attr ) );
+        }
+
         /// @todo This method needs to match each Node to the Bond with more precision.
         /// @todo See if you can break down this method and allow custom attributes & custom attribute handling.
         const double Binding::canBind ( const Node &p_ndSrc, const Node& p_ndDst ) const {
             if ( this->parentRule ()->appliesFor ( p_ndSrc ) == 0.0 )
                 return 0.0;
 
+            return rate ( p_ndSrc, p_ndDst, TypeCode ( p_ndDst.toString ( Node::EXTRA ) ) );
+        }
+
+        const double Binding::rate ( const Node &p_ndSrc, const Node& p_ndDst, const TypeCode& p_ndDestCd ) const {
             double l_rtn = 0.0;
-            const QString l_wh = m_bnd.attribute ( "with" ), l_has = m_bnd.attribute( "has" ),
-                          l_hasAll = m_bnd.attribute( "hasAll" ), l_ndDestStr = p_ndDst.toString ( Node::EXTRA ),
-                          l_ndSrcStr = p_ndSrc.toString ( Node::EXTRA );
+            const QString& l_has = m_has, &l_hasAll = m_hasAll;
+            const QString l_ndDestStr = p_ndDestCd.toString ();
+            QString l_ndSrcStr, l_bindType;
 
-            const QStringList l_options = l_wh.split ( "," );
+            if (m_chkTypHas){
+                l_ndSrcStr = p_ndSrc.toString ( Node::EXTRA );
+                l_bindType = l_ndSrcStr.at (0) + m_typHas;
+            }
 
-            foreach (const QString l_s, l_options) {
-                l_rtn = Rules::Bond::matches(l_ndDestStr , l_s);
-                const QString l_whHas = l_s.at (0) + l_has;
+            for ( int l_i = 0; l_i < m_wthCds.size (); l_i++ ) {
+                const QString l_s = m_wthCds.at ( l_i ).toString ();
+                l_rtn = TypeMatcher::matches ( p_ndDestCd , m_wthCds.at ( l_i ) );
+                const TypeCode& l_whHas = m_wthHasCds.at ( l_i );
 
                 if (l_rtn > 0.0) {
-                    qDebug() << endl << "(ling) [Binding] Src:" << l_ndSrcStr << "; Dst:" << l_ndDestStr << "; via:" << l_s << "; lvl:" << l_rtn;
+                    lingTrace ( "Binding" ) << "Src:" << p_ndSrc.toString ( Node::EXTRA ) << "; Dst:" << l_ndDestStr << "; via:" << l_s << "; lvl:" << l_rtn;
 
                     if (!l_hasAll.isEmpty ()){
                         if (!l_ndDestStr.contains (l_hasAll)){
                             l_rtn = 0.0;
-                            qDebug() << "(ling) [Binding] Required full destination node type:" << l_hasAll << "in" << l_ndDestStr;
+                            lingTrace ( "Binding" ) << "Required full destination node type:" << l_hasAll << "in" << l_ndDestStr;
                         } else {
-                            qDebug() << "(ling) [Binding] Rating up by" << ((double) l_hasAll.length () / (double) l_ndDestStr.length ()) * 100 << "% thanks to ==" << l_hasAll;
+                            lingTrace ( "Binding" ) << "Rating up by" << ((double) l_hasAll.length () / (double) l_ndDestStr.length ()) * 100 << "% thanks to ==" << l_hasAll;
                             l_rtn += ((double) l_hasAll.length () / (double) l_ndDestStr.length ());
                         }
-                    } else if (l_whHas.size () > 1){
-                        const double l_wRtn = Rules::Bond::matches (l_ndDestStr,l_whHas);
+                    } else if (l_whHas.length () > 1){
+                        const double l_wRtn = TypeMatcher::matches (p_ndDestCd,l_whHas);
                         if (l_wRtn == 0.0){
                             l_rtn = 0.0;
-                            qDebug() << "(ling) [Binding] Required partial destination node type:" << l_whHas << "in" << l_ndDestStr;
+                            lingTrace ( "Binding" ) << "Required partial destination node type:" << l_whHas.toString () << "in" << l_ndDestStr;
                         }
                         else {
-                            qDebug() << "(ling) [Binding] Rating up by" << (l_wRtn / (double) l_ndDestStr.length ()) * 100 << "% thanks to ~=" << l_whHas;
+                            lingTrace ( "Binding" ) << "Rating up by" << (l_wRtn / (double) l_ndDestStr.length ()) * 100 << "% thanks to ~=" << l_whHas.toString ();
                             l_rtn += (l_wRtn / (double) l_ndDestStr.length ());
                         }
                     }
 
-                    if (m_bnd.hasAttribute ("typeHas")){
-                        const QString l_bindType = l_ndSrcStr.at (0) + this->getAttrValue ( "typeHas" );
-                        const double l_matchVal = Rules::Bond::matches (l_ndSrcStr,l_bindType);
+                    if (m_chkTypHas){
+                        const double l_matchVal = TypeMatcher::matches (l_ndSrcStr,l_bindType);
                         const double l_min = (1.0 / (double)l_bindType.length ());
 
                         //qDebug() << l_min << l_matchVal << l_ndSrcStr << l_bindType;
                         if ( l_matchVal < l_min ){
                             l_rtn = 0.0;
-                            qDebug() << "(ling) [Binding] Required partial source node type:" << l_bindType << "in" << l_ndSrcStr;
+                            lingTrace ( "Binding" ) << "Required partial source node type:" << l_bindType << "in" << l_ndSrcStr;
                         }
                     }
 
@@ -166,7 +274,7 @@ namespace Wintermute {
             }
 
             if (l_rtn > 0.0)
-                qDebug() << "(ling) [Binding] Bond:"<< l_rtn * 100 << "% for" << p_ndSrc.symbol () << "to" << p_ndDst.symbol () << "via" << (l_wh + l_has) << endl;
+                lingDebug ( "Binding" ) << "Bond:"<< l_rtn * 100 << "% for" << p_ndSrc.symbol () << "to" << p_ndDst.symbol () << "via" << (getAttrValue ( "with" ) + l_has);
             else {
                 //qDebug() << "(ling) [Binding] Binding failed for (src) -> (dst) :" << p_ndSrc.toString (Node::EXTRA).c_str () << " -> " << l_ndDestStr.toStdString ().c_str () << " via" << l_wh;
             }
@@ -175,36 +283,51 @@ namespace Wintermute {
         }
 
         /// @todo Allow the attribute to be handle certain parts.
+        void Binding::resolve ( BindingDecision& p_dcsn, const Node& p_nd1, const Node& p_nd2 ) const {
+            QString l_type = this->parentRule ()->type ();
+            Atom l_lcl = this->parentRule ()->localeAtom ();
+            const Node *l_nd = &p_nd1, *l_nd2 = &p_nd2;
+
+            if (m_rvrs) {
+                l_type = p_nd2.toString ( Node::MINIMAL );
+                l_lcl = p_nd2.localeAtom ();
+                const Node *l_tmp = l_nd;
+                l_nd = l_nd2;
+                l_nd2 = l_tmp;
+            }
+
+            if (m_othrTyp)
+                l_type = p_nd2.toString ( Node::MINIMAL );
+            else if (m_thsTyp)
+                l_type = p_nd1.toString ( Node::MINIMAL );
+
+            p_dcsn.m_src = l_nd;
+            p_dcsn.m_dst = l_nd2;
+            p_dcsn.m_typ = l_type;
+            p_dcsn.m_lcl = l_lcl;
+        }
+
         const Link* Binding::bind ( const Node& p_nd1, const Node& p_nd2 ) const {
-            if (!canBind(p_nd1,p_nd2)){
+            BindingDecision l_dcsn;
+            l_dcsn.m_scr = canBind(p_nd1,p_nd2);
+
+            if (l_dcsn.m_scr == 0.0){
                 emit bindFailed(const_cast<Binding*>(this),&p_nd1,&p_nd2);
                 return NULL;
             }
 
-            QString l_type = this->parentRule ()->type ();
-            QString l_lcl = this->parentRule ()->locale();
-            Node *l_nd = const_cast<Node*> ( &p_nd1 ), *l_nd2 = const_cast<Node*> ( &p_nd2 );
-
-            if (m_bnd.hasAttribute ("linkAction")){
-                const QStringList l_options = m_bnd.attribute ("linkAction").split (",");
-
-                if (l_options.contains ("reverse")) {
-                    l_type = p_nd2.toString ( Node::MINIMAL ).at (0);
-                    l_lcl = p_nd2.locale ();
-                    Node *l_tmp = l_nd;
-                    l_nd = l_nd2;
-                    l_nd2 = l_tmp;
-                }
+            l_dcsn.m_bnd = this;
+            resolve ( l_dcsn, p_nd1, p_nd2 );
+            return bind ( l_dcsn );
+        }
 
-                if (l_options.contains ("othertype"))
-                    l_type = p_nd2.toString ( Node::MINIMAL ).at (0);
-                else if (l_options.contains ("thistype"))
-                    l_type = p_nd1.toString ( Node::MINIMAL ).at (0);
-            }
+        const Link* Binding::bind ( const BindingDecision& p_dcsn, Arena* p_arn ) const {
+            Q_ASSERT ( p_dcsn.binding () == this );
+            const Node *l_nd1 = p_dcsn.source (), *l_nd2 = p_dcsn.destination ();
 
-            emit binded(this,&p_nd1,&p_nd2);
-            qDebug() << "(ling) [Binding] Link formed: " << p_nd1.toString (Node::EXTRA) << p_nd2.toString (Node::EXTRA);
-            return Link::form ( *&l_nd, *&l_nd2 , l_type , l_lcl );
+            emit binded(this,l_nd1,l_nd2);
+            lingTrace ( "Binding" ) << "Link formed:" << l_nd1->toString (Node::EXTRA) << l_nd2->toString (Node::EXTRA);
+            return Link::form ( l_nd1, l_nd2 , p_dcsn.type () , p_dcsn.localeAtom () , p_arn );
         }
 
         const Rule* Binding::parentRule () const { return m_rl; }
@@ -214,101 +337,177 @@ namespace Wintermute {
         Rule::Rule(const Rules::Chain &p_chn) : m_chn(p_chn) { __init(); }
 
         void Rule::__init() {
+            m_typ = Atoms::intern ( m_chn.type () );
+            m_lcl = Atoms::intern ( m_chn.locale () );
+            m_typCds = TypeMatcher::pack ( type () );
+
             foreach (Rules::Bond l_bnd, m_chn.bonds())
                 m_bndVtr.push_back ((new Binding(l_bnd,this)));
+
+            foreach (Binding* l_bnd, m_bndVtr) {
+                foreach (const TypeCode& l_cd, l_bnd->m_wthCds) {
+                    if (l_cd.length () == 0)
+                        continue;
+
+                    BindingList& l_bkt = m_bndIdx[l_cd.toString ().at (0)];
+                    if (l_bkt.isEmpty () || l_bkt.last () != l_bnd)
+                        l_bkt << l_bnd;
+                }
+            }
         }
 
-        const Rule* Rule::obtain ( const Node& p_nd ) {
+        const BindingList Rule::candidatesFor ( const TypeCode& p_dstCd ) const {
+            if (p_dstCd.length () == 0)
+                return BindingList();
+
+            return m_bndIdx.value (p_dstCd.toString ().at (0));
+        }
+
+        QSharedPointer<const Rule> Rule::obtain ( const Node& p_nd ) {
             const QString l_lcl = p_nd.locale ();
-            const QString l_flg = p_nd.flags ().begin ().value ().toString();            
-            RuleInterface* l_int = new RuleInterface;
+            const QString l_flg = p_nd.flags ().begin ().value ().toString();
+            const RuleKey l_key ( p_nd.localeAtom (), l_flg );
+
+            {
+                QReadLocker l_lck ( &s_rlLck );
+                const RuleCache::ConstIterator l_itr = s_rls.constFind ( l_key );
+                if ( l_itr != s_rls.constEnd () )
+                    return l_itr.value ();
+            }
+
+            RuleInterface l_int;
             Rules::Chain l_chn(l_lcl,l_flg);
-            QDBusPendingReply<QString> l_reply = l_int->read(l_chn);
-            l_reply.waitForFinished();
-            qDebug() << l_reply;
+            QDBusPendingReply<QString> l_reply;
+            {
+                StageTimer l_tmr ( Metrics::RuleRead );
+                l_reply = l_int.read(l_chn);
+                l_reply.waitForFinished();
+            }
+            lingTrace ( "Rule" ) << l_reply;
+
+            if ( !l_reply.isValid () || l_reply.isError () ) {
+                lingWarning ( "Rule" ) << "Couldn't read the rule for" << l_flg << "in" << l_lcl << ":" << l_reply.error ();
+                return QSharedPointer<const Rule> ();
+            }
+
             l_chn = Rules::Chain::fromString(l_reply);
-            return new Rule(l_chn);
+            const QSharedPointer<const Rule> l_rl ( new Rule ( l_chn ) );
+
+            // Another thread may have read the same Rule meanwhile; keep whichever came first.
+            QWriteLocker l_lck ( &s_rlLck );
+            const RuleCache::ConstIterator l_itr = s_rls.constFind ( l_key );
+            if ( l_itr != s_rls.constEnd () )
+                return l_itr.value ();
+
+            s_rls.insert ( l_key, l_rl );
+            return l_rl;
+        }
+
+        void Rule::clearCache ( ) {
+            RuleCache l_old;
+            {
+                QWriteLocker l_lck ( &s_rlLck );
+                qSwap ( l_old, s_rls );
+            }
         }
 
         const Link* Rule::bind ( const Node& p_curNode, const Node& p_nextNode ) const {
-            for ( BindingList::const_iterator i = m_bndVtr.begin (); i != m_bndVtr.end (); i++ ) {
-                const Binding* l_bnd = *i;
-                if ( l_bnd->canBind ( p_curNode,p_nextNode ) )
-                    return l_bnd->bind ( p_curNode,p_nextNode );
+            if ( appliesFor ( p_curNode ) == 0.0 )
+                return NULL;
+
+            const TypeCode l_dstCd ( p_nextNode.toString ( Node::EXTRA ) );
+            foreach ( const Binding* l_bnd, candidatesFor ( l_dstCd ) ) {
+                BindingDecision l_dcsn;
+                l_dcsn.m_scr = l_bnd->rate ( p_curNode,p_nextNode,l_dstCd );
+
+                if ( l_dcsn.m_scr > 0.0 ) {
+                    l_dcsn.m_bnd = l_bnd;
+                    l_bnd->resolve ( l_dcsn, p_curNode, p_nextNode );
+                    return l_bnd->bind ( l_dcsn );
+                }
             }
 
             return NULL;
         }
 
         const bool Rule::canBind ( const Node& p_nd, const Node &p_dstNd ) const {
-            for ( BindingList::const_iterator i = m_bndVtr.begin (); i != m_bndVtr.end (); i++ ) {
-                const Binding* l_bnd = *i;
-                if ( l_bnd->canBind ( p_nd,p_dstNd ) )
+            if ( appliesFor ( p_nd ) == 0.0 )
+                return false;
+
+            const TypeCode l_dstCd ( p_dstNd.toString ( Node::EXTRA ) );
+            foreach ( const Binding* l_bnd, candidatesFor ( l_dstCd ) ) {
+                if ( l_bnd->rate ( p_nd,p_dstNd,l_dstCd ) > 0.0 )
                     return true;
             }
 
             return false;
         }
 
-        const Binding* Rule::getBindingFor ( const Node& p_nd, const Node& p_nd2 ) const {
-            typedef QMap<double, Binding*> RatedBindingMap;
-
-            RatedBindingMap l_bndLevel;
-            for ( BindingList::const_iterator i = m_bndVtr.begin (); i != m_bndVtr.end (); i++ ) {
-                const Binding* l_bnd = *i;
-                double l_vl = l_bnd->canBind ( p_nd,p_nd2 );
-                if ( l_vl ){
-                    l_bndLevel.insert(l_vl,const_cast<Binding*>(l_bnd));
-                    //qDebug() << "(ling) [Rule] Valid binding for" << p_nd.symbol () << "to" << p_nd2.symbol ();
+        const BindingDecision Rule::getBindingFor ( const Node& p_nd, const Node& p_nd2 ) const {
+            BindingDecision l_dcsn;
+            RatedBindingList l_rtd;
+
+            if ( appliesFor ( p_nd ) > 0.0 ) {
+                const TypeCode l_dstCd ( p_nd2.toString ( Node::EXTRA ) );
+                // Gathered in reverse order of definition, so that the stable sort lets the last-defined Binding win a tie.
+                foreach ( const Binding* l_bnd, candidatesFor ( l_dstCd ) ) {
+                    const double l_vl = l_bnd->rate ( p_nd,p_nd2,l_dstCd );
+                    if ( l_vl != 0.0 )
+                        l_rtd.prepend ( RatedBinding ( l_vl, l_bnd ) );
                 }
             }
 
-            if (!l_bndLevel.empty ()){
-                const Binding* l_bnd = l_bndLevel.values().last();
-                const double l_rate = l_bndLevel.keys().last();
-                if (l_rate > 0.0) {
-                    qDebug() << "(ling) [Rule] Highest binding for" << p_nd.symbol() << "at" << l_rate * 100 << "%";
-                    return l_bnd;
-                }
+            qStableSort ( l_rtd.begin (), l_rtd.end (), rankedHigher );
+
+            if (!l_rtd.isEmpty () && l_rtd.first ().first > 0.0){
+                const RatedBinding l_bst = l_rtd.takeFirst ();
+
+                l_dcsn.m_bnd = l_bst.second;
+                l_dcsn.m_scr = l_bst.first;
+                l_dcsn.m_rnrs = l_rtd;
+                l_bst.second->resolve ( l_dcsn, p_nd, p_nd2 );
+
+                lingDebug ( "Rule" ) << "Highest binding for" << p_nd.symbol() << "at" << l_dcsn.m_scr * 100 << "%";
+                return l_dcsn;
             }
 
-            qDebug() << "(ling) [Rule] No bindings found for" << p_nd.toString(Node::EXTRA) << "to" << p_nd2.toString(Node::EXTRA);
-            return NULL;
+            lingTrace ( "Rule" ) << "No bindings found for" << p_nd.toString(Node::EXTRA) << "to" << p_nd2.toString(Node::EXTRA);
+            return l_dcsn;
         }
 
         const double Rule::appliesFor ( const Node& p_nd ) const {
-            const QString l_ndStr ( p_nd.toString ( Node::EXTRA ) );
-            const QString l_rlStr ( type() );
-            const double l_rtn = Rules::Bond::matches( l_ndStr , l_rlStr );
+            const TypeCode l_ndCd ( p_nd.toString ( Node::EXTRA ) );
+            const double l_rtn = TypeMatcher::matches ( l_ndCd , m_typCds );
 
             return l_rtn;
         }
 
-        const QString Rule::type() const { return m_chn.type (); }
+        const QString Rule::type() const { return Atoms::toString ( m_typ ); }
 
-        const QString Rule::locale () const { return m_chn.locale(); }
+        const QString Rule::locale () const { return Atoms::toString ( m_lcl ); }
 
-        Parser::Parser ( const QString& p_lcl ) : m_lcl ( p_lcl ) { }
+        Parser::Parser ( const QString& p_lcl ) : m_lcl ( p_lcl ), m_pthLmt ( 0 ), m_cch ( NULL ) { }
 
         const QString Parser::locale () const {
             return m_lcl;
         }
 
         void Parser::setLocale ( const QString& p_lcl ) {
+            if ( m_actv != 0 ) {
+                lingWarning ( "Parser" ) << "Can't change the locale to" << p_lcl << "while parsing in" << m_lcl << ".";
+                return;
+            }
+
             m_lcl = p_lcl;
         }
 
-        QStringList Parser::getTokens ( const QString &p_str ) {
-            QStringList l_strLst;
-            foreach(const Token* l_tkn, Token::form(p_str)){
-                const QString l_fullSuffix = Lexical::Cache::obtainFullSuffix(locale(),l_tkn->suffix());
-                l_strLst << l_tkn->symbol();
-
-                if (!l_fullSuffix.isEmpty())
-                    l_strLst << l_fullSuffix;
-            }
-
-            return l_strLst;
+        const TokenStore& Parser::getTokens ( ParseContext& p_ctx, const QString &p_str, const SentenceRange& p_sntnc ) {
+            StageTimer l_tmr ( Metrics::Tokenize );
+            if ( p_ctx.hasExpired () )
+                p_ctx.m_tknStr.clear ();
+            else
+                p_ctx.m_tknStr.tokenize (p_str, p_sntnc.m_pos, p_sntnc.m_len);
+            return p_ctx.m_tknStr;
         }
 #if 0
         /// @todo Remove this method (but salvage the algorithm for saving a node). [Use it in ncurses-wintermute.]
@@ -320,7 +519,7 @@ namespace Wintermute {
             QTextStream l_iStrm(stdin);
 
             if (l_iStrm.readLine () == "yes"){
-                const Lexical::Data* l_dt = p_nd->data();
+                const Lexical::Data l_dt = p_nd->data();
                 cout << "(ling) Enter lexical flags in such a manner; ONTOID LEXIDATA. Press <ENTER> twice to complete the flag entering process." << endl;
                 QString l_oid, l_flg, l_ln = l_iStrm.readLine ();
                 QVariantMap l_dtmp;
@@ -344,24 +543,45 @@ namespace Wintermute {
             }
         }
 #endif
-        NodeList Parser::formNodes ( QStringList const &p_tokens ) {
+        NodeList Parser::formNodes ( ParseContext& p_ctx, const TokenStore &p_tokens ) {
+            StageTimer l_tmr ( Metrics::FormNodes );
             NodeList l_theNodes;
 
-            foreach(QString l_token, p_tokens){
-                Node* l_node = formNode(l_token);
+            for (int l_i = 0; l_i < p_tokens.size (); l_i++){
+                if ( p_ctx.hasExpired () ) {
+                    lingInfo ( "Parser" ) << "Stopped forming nodes after" << l_i << "of" << p_tokens.size () << "tokens.";
+                    break;
+                }
+
+                Node* l_node = formNode(p_ctx, p_tokens.symbol (l_i).toString ());
                 if (l_node)
                     l_theNodes.push_back(l_node);
+
+                if (p_tokens.at (l_i).m_sffx == 0)
+                    continue;
+
+                QString l_fullSuffix;
+                {
+                    StageTimer l_sfxTmr ( Metrics::SuffixLookup );
+                    l_fullSuffix = Lexical::Cache::obtainFullSuffix(locale(),p_tokens.suffix (l_i).toString ());
+                }
+
+                if (!l_fullSuffix.isEmpty()){
+                    l_node = formNode(p_ctx, l_fullSuffix);
+                    if (l_node)
+                        l_theNodes.push_back(l_node);
+                }
             }
 
             return l_theNodes;
         }
 
-        Node* Parser::formNode( const QString &p_symbol ){
+        Node* Parser::formNode( ParseContext& p_ctx, const QString &p_symbol ){
             const QString l_theID = Lexical::Data::idFromString (p_symbol);
-            Node* l_theNode = const_cast<Node*>(Node::obtain (m_lcl,l_theID));
+            Node* l_theNode = Node::obtain (m_lcl,l_theID,p_ctx.arena ());
 
-            if ( !Node::exists (m_lcl,l_theID) ) {
-                l_theNode = const_cast<Node*>(Node::buildPseudo ( m_lcl, p_symbol ));
+            if ( !l_theNode ) {
+                l_theNode = Node::buildPseudo ( m_lcl, p_symbol, p_ctx.arena () );
                 emit foundPseduoNode(l_theNode);
             }
 
@@ -371,44 +591,25 @@ namespace Wintermute {
             return l_theNode;
         }
 
-        void Parser::doUnwindingProgressStep() { m_prg += 1; }
-
-        /// @todo Find a means of reporting progress from this method; this method can end up becoming extremely time-consuming.
-        NodeTree Parser::expandNodes ( NodeTree& p_tree, const int& p_size, const int& p_level ) {
-            if ( p_level == p_tree.size () ){
-                qDebug() << "(ling) Cannot unwind anymore.";
-                return ( NodeTree() );
-            }
-
-            const NodeList l_curBranch = p_tree.at ( p_level );
-            const bool l_atEnd = ( p_level + 1 == p_tree.size () );
-
-            if ( l_curBranch.isEmpty () ) {
-                qDebug() << "(ling) [Parser] WARNING: Null data detected at level" << p_level << ".";
-                return ( NodeTree() );
-            }
+        void Parser::doUnwindingProgressStep( ParseContext& p_ctx ) {
+            p_ctx.m_prg += 1;
+            reportProgress ( p_ctx );
+        }
 
-            const int l_maxSize = p_size / l_curBranch.size ( );
-            NodeTree l_childBranches, l_foundStems = expandNodes ( p_tree , l_maxSize , p_level + 1 );
+        void Parser::reportProgress ( ParseContext& p_ctx, const bool& p_frc ) {
+            const qint64 l_elpsd = p_ctx.m_prgTmr.isValid () ? p_ctx.m_prgTmr.elapsed () : 0;
+            if ( !p_frc && l_elpsd - p_ctx.m_prgLst < s_prgIntrvl )
+                return;
 
-            foreach (Node* l_curNodeForm, l_curBranch){
-                if ( !l_atEnd ) {
-                    foreach (NodeList l_curLst, l_foundStems){
-                        NodeList l_tmpLst; // creates the current vector [1 of x, x = l_curBranch.size()];
-                        l_tmpLst << l_curNodeForm << l_curLst;
-                        l_childBranches << l_tmpLst; // add this current branch to list.
-                        doUnwindingProgressStep();
-                    }
-                } else { // the end of the line!
-                    NodeList l_tmpLst;
-                    l_tmpLst << l_curNodeForm;
-                    l_childBranches << l_tmpLst; // add this current branch to list.
-                    doUnwindingProgressStep();
-                }
-           }
+            p_ctx.m_prgLst = l_elpsd;
+            const PathIndex l_dn = p_ctx.m_prg, l_ttl = p_ctx.m_prgMax;
+            const double l_sntncFrctn = l_ttl == 0 ? 1.0 : (double) l_dn / (double) l_ttl;
+            const double l_frctn = qMin ( 1.0, ( p_ctx.m_sntnc + l_sntncFrctn ) / qMax ( 1, p_ctx.m_sntncCnt ) );
+            const double l_rt = l_elpsd > 0 ? l_dn * 1000.0 / l_elpsd : 0.0;
+            const qint64 l_eta = l_dn >= l_ttl ? 0 : ( l_rt > 0.0 ? (qint64) ( ( l_ttl - l_dn ) * 1000.0 / l_rt ) : -1 );
 
-            qDebug() << "(ling) [Parser] Tier" << (p_tree.size () * p_level) << ((l_childBranches.size () != p_size) ? (QString("generated") + QString::number (l_childBranches.size()) + QString("of its") + QString(p_size)) : (QString("all of its"))).toStdString ().c_str () << "expected branches.";
-            return l_childBranches;
+            emit unwindingProgress ( l_frctn );
+            emit progressed ( &p_ctx, l_frctn, l_rt, l_eta );
         }
 
         /**
@@ -426,37 +627,66 @@ namespace Wintermute {
          *        =  2 *  3 *  2
          *        = 12
          */
-        NodeTree Parser::expandNodes ( const NodeList &p_baseNodeVtr ) {
-            int l_totalPaths = 1;
-            NodeTree l_metaTree;
+        const PathSpace& Parser::expandNodes ( ParseContext& p_ctx, const NodeList &p_baseNodeVtr ) {
+            StageTimer l_tmr ( Metrics::ExpandNodes );
+            QVector<NodeList>& l_vrnts = p_ctx.m_vrnts;
+            PathSpace& l_pths = p_ctx.m_pths;
+            l_vrnts.clear ();
+            l_pths.clear ();
 
             if (!p_baseNodeVtr.isEmpty ()){
-                for ( NodeList::ConstIterator l_itr = p_baseNodeVtr.begin (); l_itr != p_baseNodeVtr.end (); l_itr++ ) {
-                    const Node* l_curNode = *l_itr;
-                    NodeList l_curNodeForms = Node::expand ( l_curNode );
+                QSet<QString> l_seen;
+
+                for ( int l_wrd = 0; l_wrd < p_baseNodeVtr.size (); l_wrd++ ) {
+                    // A sentence missing a word has no paths; drop what's been expanded so far.
+                    if ( p_ctx.hasExpired () ) {
+                        lingInfo ( "Parser" ) << "Stopped expanding nodes after" << l_wrd << "of" << p_baseNodeVtr.size () << "words.";
+                        l_vrnts.clear ();
+                        l_pths.clear ();
+                        return l_pths;
+                    }
+
+                    const Node* l_curNode = p_baseNodeVtr.at ( l_wrd );
+
+                    // A word that repeats within the sentence gets its own variants, so that
+                    // each occurrence stays a distinct Node in the formed Meaning.
+                    bool l_shrd = true;
+                    if ( l_seen.contains ( l_curNode->id () ) )
+                        l_shrd = false;
+                    else
+                        l_seen.insert ( l_curNode->id () );
+
+                    const NodeList l_curNodeForms = Node::expand ( l_curNode, l_shrd, p_ctx.arena () );
                     const unsigned int size = l_curNodeForms.size ();
                     Q_ASSERT(size >= 1);
 
-                    if ( l_itr != p_baseNodeVtr.begin() )
-                        l_totalPaths *= size;
+                    NodeCodeList l_cds;
+                    l_cds.reserve ( size );
+                    for ( int l_vrnt = 0; l_vrnt < l_curNodeForms.size (); l_vrnt++ )
+                        l_cds << NodeCode::form ( l_wrd, l_vrnt );
 
-                    l_metaTree << l_curNodeForms;
+                    l_vrnts << l_curNodeForms;
+                    l_pths.append ( l_cds );
                 }
 
-                qDebug() << "(ling) [Parser] Expecting" << l_totalPaths << "path(s).";
+                p_ctx.m_prg = 0;
+                lingDebug ( "Parser" ) << "Found" << l_pths.count () << "path(s).";
+
+                emit finishedUnwinding();
+            } else
+                lingDebug ( "Parser" ) << "No nodes to generate paths from found.";
 
-                emit unwindingProgress(0.0);
-                NodeTree l_tree = expandNodes ( l_metaTree , l_totalPaths , 0 );
-                emit unwindingProgress(1.0);
+            return l_pths;
+        }
 
-                qDebug() << "(ling) [Parser] Found" << l_tree.size() << "path(s).";
+        const NodeList Parser::nodesOf ( const ParseContext& p_ctx, const NodeCodeList& p_path ) const {
+            NodeList l_ndLst;
+            l_ndLst.reserve ( p_path.size () );
 
-                emit finishedUnwinding();
-                return l_tree;
-            } else {
-                qDebug() << "(ling) [Parser] No nodes to generate paths from found.";
-                return NodeTree();
-            }
+            foreach ( const NodeCode& l_cd, p_path )
+                l_ndLst << p_ctx.m_vrnts.at ( l_cd.m_wrd ).at ( l_cd.m_vrnt );
+
+            return l_ndLst;
         }
 
         /// @todo Determine a means of generating unique signatures for each set of Nodes (to reduce the unwinding time).
@@ -471,51 +701,171 @@ namespace Wintermute {
             return l_ndShrthnd;
         }
 
+        const Parser::Status Parser::parse ( const QString& p_txt, const CancelToken* p_tkn ) {
+            m_ctx.setCancelToken ( p_tkn );
+            const Status l_sts = parse ( m_ctx, p_txt );
+            m_ctx.setCancelToken ( NULL );
+            return l_sts;
+        }
+
         /// @todo When parsing multiple sentences back-to-back; we need to implement a means of maintaining context. [Can't be done without implementing context ;)]
-        void Parser::parse ( const QString& p_txt ) {
-            QTextStream l_strm(p_txt.toLocal8Bit (),QIODevice::ReadOnly);
+        const Parser::Status Parser::parse ( ParseContext& p_ctx, const QString& p_txt ) {
+            StageTimer l_tmr ( Metrics::Parse );
             MeaningList l_mngVtr;
+            m_actv.ref ();
+            const int l_pn = Node::pinExpansions ();
+
+            p_ctx.m_sntncCnt = m_sgmntr.segment (p_txt, p_ctx.m_sntncs);
+            lookupResults ( p_ctx, p_txt );
+
+            if ( p_ctx.m_sntncCnt > 1 )
+                parseStaged ( p_ctx, p_txt, l_mngVtr );
+            else for (int l_i = 0; l_i < p_ctx.m_sntncCnt; l_i++){
+                if ( p_ctx.hasExpired () ) {
+                    lingInfo ( "Parser" ) << "Parse called off after" << l_i << "of" << p_ctx.m_sntncCnt << "sentences.";
+                    break;
+                }
 
-            while (!l_strm.atEnd ()){
-                QString l_str = l_strm.readLine ();
-                QStringList l_sentences = l_str.split (QRegExp("[.!?;]\\s"),QString::SkipEmptyParts);
+                if ( p_ctx.m_dn.at (l_i) )
+                    continue;
 
-                foreach (QString l_sentence, l_sentences){
-                    if (l_sentences.front () != l_sentence)
-                        qDebug() << "Parsing next sentence...";
+                if (l_i != 0)
+                    lingDebug ( "Parser" ) << "Parsing next sentence...";
 
-                    Meaning* l_mng = const_cast<Meaning*>( process ( l_sentence ) );
+                p_ctx.m_sntnc = l_i;
+                Meaning* l_mng = const_cast<Meaning*>( process ( p_ctx, p_txt, p_ctx.m_sntncs.at (l_i) ) );
+                recordResult ( p_ctx, l_i, l_mng );
 #if 0
-                    /// @todo Connect this meaning to the last meaning. (Implement context?)
-                    if (!l_mngVtr.isEmpty ())
-                        l_mng->connectWith(l_mngVtr.last ());
+                /// @todo Connect this meaning to the last meaning. (Implement context?)
+                if (!l_mngVtr.isEmpty ())
+                    l_mng->connectWith(l_mngVtr.last ());
 #endif
 
-                    if (l_mng) {
-                        l_mngVtr.push_back (l_mng);
-                    }
+                if (l_mng) {
+                    l_mngVtr.push_back (l_mng);
                 }
             }
+
+            Status l_sts = Completed;
+            if ( p_ctx.hasExpired () ) {
+                if ( !l_mngVtr.isEmpty () || p_ctx.m_dn.contains ( true ) )
+                    l_sts = Partial;
+                else
+                    l_sts = p_ctx.cancelToken ()->isCancelled () ? Cancelled : TimedOut;
+            }
+
+            // Everything formed for this text lives in the context's arena; release it all at once.
+            l_mngVtr.clear ();
+            p_ctx.reset ();
+            Node::unpinExpansions ( l_pn );
+            m_actv.deref ();
+            return l_sts;
+        }
+
+        void Parser::parseStaged ( ParseContext& p_ctx, const QString& p_txt, MeaningList& p_mngVtr ) {
+            StageQueue<StagedSentence> l_q ( s_stgDpth );
+            QSemaphore l_fnshd;
+            stagePool ()->start ( new LookupStage ( this, p_ctx.lookupContext (), &p_txt, &p_ctx.m_sntncs, p_ctx.m_sntncCnt, &p_ctx.m_dn, &l_q, &l_fnshd ) );
+
+            StagedSentence l_sntnc;
+            for ( int l_i = 0; l_q.pop ( l_sntnc ); l_i++ ) {
+                if ( p_ctx.hasExpired () ) {
+                    lingInfo ( "Parser" ) << "Parse called off after" << l_i << "of" << p_ctx.m_sntncCnt << "sentences.";
+                    break;
+                }
+
+                if (l_i != 0)
+                    lingDebug ( "Parser" ) << "Parsing next sentence...";
+
+                p_ctx.m_vrnts = l_sntnc.m_vrnts;
+                p_ctx.m_pths = l_sntnc.m_pths;
+                p_ctx.m_sntnc = l_sntnc.m_indx;
+                Meaning* l_mng = const_cast<Meaning*>( formMeanings ( p_ctx ) );
+                recordResult ( p_ctx, l_sntnc.m_indx, l_mng );
+
+                if (l_mng)
+                    p_mngVtr.push_back (l_mng);
+            }
+
+            // The lookup stage works on the text and sentences of this call; wait for it to let go.
+            l_q.abort ();
+            l_fnshd.acquire ();
+        }
+
+        void Parser::lookupResults ( ParseContext& p_ctx, const QString& p_txt ) {
+            const int l_cnt = p_ctx.m_sntncCnt;
+            p_ctx.m_rslts.fill ( QByteArray (), l_cnt );
+            p_ctx.m_dn.fill ( false, l_cnt );
+            p_ctx.m_keys.resize ( l_cnt );
+            p_ctx.m_rvsn = Node::revision ();
+
+            if ( !m_cch )
+                return;
+
+            for ( int l_i = 0; l_i < l_cnt; l_i++ ) {
+                const SentenceRange& l_sntnc = p_ctx.m_sntncs.at ( l_i );
+                p_ctx.m_keys[l_i] = ResultCache::keyOf ( m_lcl, p_txt.mid ( l_sntnc.m_pos, l_sntnc.m_len ) );
+                p_ctx.m_dn[l_i] = m_cch->find ( p_ctx.m_keys.at ( l_i ), p_ctx.m_rslts[l_i] );
+            }
+        }
+
+        void Parser::recordResult ( ParseContext& p_ctx, const int& p_indx, const Meaning* p_mng ) {
+            p_ctx.m_rslts[p_indx] = resultOf ( p_mng );
+
+            // A sentence cut short, or tried on only some of its paths, isn't its own best result.
+            if ( m_cch && m_pthLmt == 0 && !p_ctx.hasExpired () )
+                m_cch->insert ( p_ctx.m_keys.at ( p_indx ), p_ctx.m_rslts.at ( p_indx ), p_ctx.m_rvsn );
+        }
+
+        const QByteArray Parser::resultOf ( const Meaning* p_mng ) {
+            if ( !p_mng )
+                return QByteArray ();
+
+            return p_mng->toBinary ();
+        }
+
+        void Parser::lookup ( ParseContext& p_ctx, const QString& p_txt, const SentenceRange& p_sntnc ) {
+            const TokenStore& l_tokens = getTokens ( p_ctx, p_txt, p_sntnc );
+            const NodeList l_theNodes = formNodes ( p_ctx, l_tokens );
+            expandNodes ( p_ctx, l_theNodes );
+        }
+
+        const Meaning* Parser::process ( ParseContext& p_ctx, const QString& p_txt, const SentenceRange& p_sntnc ) {
+            lookup ( p_ctx, p_txt, p_sntnc );
+            return formMeanings ( p_ctx );
         }
 
         /// @todo Obtain the one meaning that represents the entire parsed text.
-        const Meaning* Parser::process ( const QString& p_txt ) {
-            QStringList l_tokens = getTokens ( p_txt );
-            NodeList l_theNodes = formNodes ( l_tokens );
-            NodeTree l_nodeTree = expandNodes ( l_theNodes );
+        const Meaning* Parser::formMeanings ( ParseContext& p_ctx ) {
+            StageTimer l_tmr ( Metrics::FormMeanings );
+            const PathSpace& l_pths = p_ctx.m_pths;
+            const PathIndex l_lmt = m_pthLmt;
+            const PathIndex l_cnt = l_lmt == 0 ? l_pths.count () : qMin ( l_pths.count (), l_lmt );
+            NodeCodeList& l_path = p_ctx.m_pth;
 
             MeaningList l_meaningVtr;
-            for ( NodeTree::const_iterator itr = l_nodeTree.begin (); itr != l_nodeTree.end (); itr++ ) {
-                const NodeList l_ndVtr = *itr;
-                qDebug() << "(ling) [Parser] Forming meaning #" << (l_meaningVtr.size () + 1) << "...";
-                Meaning* l_meaning = const_cast<Meaning*>(Meaning::form ( NULL, l_ndVtr ));
+            PathIndex l_indx = 0;
+            p_ctx.m_prg = 0;
+            p_ctx.m_prgMax = l_cnt;
+            p_ctx.m_prgLst = 0;
+            p_ctx.m_prgTmr.start ();
+            reportProgress ( p_ctx, true );
+            for ( ; l_indx < l_cnt; l_indx++ ) {
+                if ( p_ctx.hasExpired () )
+                    break;
+
+                l_pths.decode ( l_indx, l_path );
+                const NodeList l_ndVtr = nodesOf ( p_ctx, l_path );
+                lingTrace ( "Parser" ) << "Forming meaning #" << (l_meaningVtr.size () + 1) << "...";
+                Meaning* l_meaning = const_cast<Meaning*>(Meaning::form ( l_ndVtr, p_ctx ));
                 if (l_meaning != NULL)
                     l_meaningVtr.push_back ( l_meaning );
+                doUnwindingProgressStep( p_ctx );
             }
+            reportProgress ( p_ctx, true );
 
             unique ( l_meaningVtr.begin(),l_meaningVtr.end () );
-            qDebug() << "(ling) [Parser]" << l_nodeTree.size () << "paths formed" << l_meaningVtr.size () << "meanings.";
-            cout << endl << setw(20) << setfill('=') << " " << endl;
+            lingDebug ( "Parser" ) << l_indx << "of" << l_pths.count () << "paths formed" << l_meaningVtr.size () << "meanings.";
 
             for ( MeaningList::const_iterator itr2 = l_meaningVtr.begin (); itr2 != l_meaningVtr.end (); itr2++ ) {
                 const Meaning* l_mngItr = *itr2;
@@ -24,8 +24,21 @@
 #define __PARSER_HPP__
 
 #include <QList>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <QAtomicInt>
+#include <QSharedPointer>
 #include <wntrdata.hpp>
 #include "syntax.hpp"
+#include "matching.hpp"
+#include "tokens.hpp"
+#include "arena.hpp"
+#include "paths.hpp"
+#include "cancel.hpp"
+#include "context.hpp"
+#include "pipeline.hpp"
+#include "cache.hpp"
 
 namespace Wintermute {
     namespace Linguistics {
@@ -35,6 +48,7 @@ namespace Wintermute {
         class Meaning;
         class Token;
         class Node;
+        class LookupStage;
 
         /**
          * @brief Represents a QList of NodeList objects.
@@ -168,6 +182,109 @@ namespace Wintermute {
                 QString m_data;
         };
 
+        /**
+         * @brief Represents a Binding paired with the score it earned for two Node objects.
+         * @see BindingDecision::runnersUp()
+         * @typedef RatedBinding
+         */
+        typedef QPair<double, const Binding*> RatedBinding;
+
+        /**
+         * @brief Represents a QList of RatedBinding objects.
+         * @typedef RatedBindingList
+         */
+        typedef QList<RatedBinding> RatedBindingList;
+
+        /**
+         * @brief Represents the outcome of choosing a Binding for a pair of Node objects.
+         *
+         * Rule::getBindingFor() scores every Binding of a Rule exactly once and records
+         * the result here: the Binding that won, its score, the remaining candidates
+         * ranked by their score and the Link that the winner resolves to (its direction,
+         * type and locale, after the 'linkAction' attribute has been applied). The
+         * decision can then be handed to Binding::bind() to form the Link without
+         * scoring the Node objects all over again. A decision keeps the shared Rule
+         * of its Binding alive for as long as it's around.
+         *
+         * @class BindingDecision parser.hpp "src/parser.hpp"
+         */
+        class BindingDecision {
+            friend class Binding;
+            friend class Rule;
+
+            public:
+                /**
+                 * @brief Null constructor; represents a failed decision.
+                 * @fn BindingDecision
+                 */
+                BindingDecision() : m_bnd(NULL), m_scr(0.0), m_src(NULL), m_dst(NULL), m_typ(), m_lcl(0) { }
+
+                /**
+                 * @brief Determines if a Binding was chosen.
+                 * @fn isValid
+                 */
+                inline const bool isValid() const { return m_bnd != NULL; }
+
+                /**
+                 * @brief Obtains the chosen Binding.
+                 * @fn binding
+                 * @return The Binding with the highest score, or NULL if none could bind.
+                 */
+                inline const Binding* binding() const { return m_bnd; }
+
+                /**
+                 * @brief Obtains the score of the chosen Binding.
+                 * @fn score
+                 */
+                inline const double score() const { return m_scr; }
+
+                /**
+                 * @brief Obtains the other Binding objects that could bind, from the best to the worst.
+                 * @fn runnersUp
+                 */
+                inline const RatedBindingList& runnersUp() const { return m_rnrs; }
+
+                /**
+                 * @brief Obtains the source Node of the resolved Link.
+                 * @fn source
+                 */
+                inline const Node* source() const { return m_src; }
+
+                /**
+                 * @brief Obtains the destination Node of the resolved Link.
+                 * @fn destination
+                 */
+                inline const Node* destination() const { return m_dst; }
+
+                /**
+                 * @brief Obtains the type of the resolved Link.
+                 * @fn type
+                 */
+                inline const QString type() const { return m_typ; }
+
+                /**
+                 * @brief Obtains the locale of the resolved Link.
+                 * @fn locale
+                 */
+                inline const QString locale() const { return Atoms::toString ( m_lcl ); }
+
+                /**
+                 * @brief Obtains the interned locale of the resolved Link.
+                 * @fn localeAtom
+                 */
+                inline const Atom localeAtom() const { return m_lcl; }
+
+            private:
+                const Binding* m_bnd;
+                QSharedPointer<const Rule> m_rl;
+                double m_scr;
+                RatedBindingList m_rnrs;
+                const Node* m_src;
+                const Node* m_dst;
+                QString m_typ;
+                Atom m_lcl;
+        };
+
         /**
          * @brief Represents the potential connection of words by a specified rule as defined by its parent rule.
          *
@@ -215,13 +332,13 @@ namespace Wintermute {
                  */
                 ~Binding() { }
                 /**
-                 * @brief
-                 *
+                 * @brief Decides which Binding, if any, links two Node objects.
                  * @fn obtain
-                 * @param
-                 * @param
+                 * @param p_nd The source Node.
+                 * @param p_nd2 The destination Node.
+                 * @see Rule::getBindingFor()
                  */
-                static const Binding* obtain ( const Node&, const Node& );
+                static const BindingDecision obtain ( const Node&, const Node& );
                 /**
                  * @brief
                  * @fn parentRule
@@ -240,6 +357,18 @@ namespace Wintermute {
                  * @param
                  */
                 const QString getAttrValue ( const QString& ) const;
+                /**
+                 * @brief Obtains the value of an attribute.
+                 *
+                 * The attributes the Parser consults while linking are read when the
+                 * Binding is formed and kept by their interned names, so looking one of
+                 * them up is an integer hash lookup.
+                 *
+                 * @fn attribute
+                 * @param p_attr The interned name of the attribute.
+                 * @return The value, or an empty QString if the attribute isn't set.
+                 */
+                const QString attribute ( const Atom& ) const;
                 /**
                  * @brief
                  * @fn bind
@@ -247,6 +376,13 @@ namespace Wintermute {
                  * @param
                  */
                 const Link* bind ( const Node&, const Node& ) const;
+                /**
+                 * @brief Forms the Link described by a BindingDecision, without scoring it again.
+                 * @fn bind
+                 * @param p_dcsn A valid decision whose chosen Binding is this one.
+                 * @param p_arn The Arena to create the Link in, or NULL to create it on the heap.
+                 */
+                const Link* bind ( const BindingDecision&, Arena* = NULL ) const;
 
             protected:
                 /**
@@ -258,12 +394,30 @@ namespace Wintermute {
                 Binding ( const Rules::Bond& , const Rule* );
 
             private:
+                void resolve ( BindingDecision&, const Node&, const Node& ) const;
+                const double rate ( const Node&, const Node&, const TypeCode& ) const;
                 Rules::Bond m_bnd;
                 const Rule* m_rl;
+                TypeCodeList m_wthCds;
+                TypeCodeList m_wthHasCds;
+                QHash<Atom, QString> m_attrs;
+                QString m_has;
+                QString m_hasAll;
+                QString m_typHas;
+                bool m_chkTypHas;
+                bool m_rvrs;
+                bool m_othrTyp;
+                bool m_thsTyp;
         };
 
         /**
          * @brief Represents a set of bindings that permit linguistics links to be converted into ontological links.
+         *
+         * Each Rule indexes its Binding objects by the first character of the options
+         * in their 'with' attribute. Since a Binding can only bind to a destination Node
+         * whose type starts like one of those options, only the Binding objects filed
+         * under the destination's leading character are ever scored.
+         *
          * @class Rule parser.hpp "src/parser.hpp"
          */
         class Rule : public QObject {
@@ -273,7 +427,11 @@ namespace Wintermute {
 
             friend class RuleSet;
             public:
-                virtual ~Rule() { }
+                /**
+                 * @brief Deconstructor; deletes the Binding objects of this Rule.
+                 * @fn ~Rule
+                 */
+                virtual ~Rule() { qDeleteAll ( m_bndVtr ); }
                 /**
                  * @brief Copy constructor.
                  * @fn Rule
@@ -294,10 +452,23 @@ namespace Wintermute {
                 explicit Rule( );
                 /**
                  * @brief Returns a Rule that's satisified by this Node.
+                 *
+                 * The Rule of each (locale, flag) is read and indexed once, then shared by
+                 * every parse until clearCache() is called.
+                 *
                  * @fn obtain
                  * @param Node A qualifying Node.
+                 * @return The shared Rule, or a null pointer if it couldn't be read.
                  */
-                static const Rule* obtain ( const Node & );
+                static QSharedPointer<const Rule> obtain ( const Node & );
+                /**
+                 * @brief Drops every shared Rule; the next parse reads the rules again.
+                 *
+                 * A Rule still used by a parse lives on until that parse lets go of it.
+                 *
+                 * @fn clearCache
+                 */
+                static void clearCache ( );
                 /**
                  * @brief Determines if this Node can be binded with a Node that falls under this rule.
                  * @fn canBind
@@ -317,12 +488,22 @@ namespace Wintermute {
                  * @fn type
                  */
                 const QString type() const;
+                /**
+                 * @brief Obtains the interned type of this Rule.
+                 * @fn typeAtom
+                 */
+                inline const Atom typeAtom() const { return m_typ; }
                 /**
                  * @brief
                  *
                  * @fn locale
                  */
                 const QString locale() const;
+                /**
+                 * @brief Obtains the interned locale of this Rule.
+                 * @fn localeAtom
+                 */
+                inline const Atom localeAtom() const { return m_lcl; }
                 /**
                  * @brief Determines if a Node is qualified to use this Rule.
                  * @fn appliesFor
@@ -330,17 +511,28 @@ namespace Wintermute {
                  */
                 const double appliesFor ( const Node& ) const;
                 /**
-                 * @brief Returns a pointer to the Binding that works for the two specified Nodes.
+                 * @brief Decides which Binding works best for the two specified Nodes.
+                 *
+                 * Every Binding is scored once. Of the Bindings with equal scores, the one
+                 * defined last by the Rule wins, and the others become runners-up. A
+                 * Binding is only chosen if its score is above zero.
+                 *
                  * @fn getBindingFor
                  * @param Node The source Node in question.
                  * @param Node The destination Node in question.
+                 * @return The decision; check BindingDecision::isValid() before using it.
                  */
-                const Binding* getBindingFor ( const Node&, const Node& ) const;
+                const BindingDecision getBindingFor ( const Node&, const Node& ) const;
 
             private:
                 void __init();
+                const BindingList candidatesFor ( const TypeCode& ) const;
                 Rules::Chain m_chn;
                 BindingList m_bndVtr;
+                QHash<QChar, BindingList> m_bndIdx;
+                TypeCodeList m_typCds;
+                Atom m_typ;
+                Atom m_lcl;
         };
 
         /**
@@ -483,12 +675,23 @@ namespace Wintermute {
             Q_PROPERTY(const QString locale READ locale WRITE setLocale)
 
             public:
+                /**
+                 * @brief Represents how far a call to parse() got.
+                 * @enum Status
+                 */
+                enum Status {
+                    Completed = 0, /**< Every sentence was parsed. */
+                    Partial, /**< The parse was called off, but some sentences had already formed a meaning. */
+                    TimedOut, /**< The deadline passed before any meaning was formed. */
+                    Cancelled /**< The parse was cancelled before any meaning was formed. */
+                };
+
                 /**
                  * @brief Copy constructor.
                  * @fn Parser
                  * @param p_prsr The Parser to be copied.
                  */
-                Parser( const Parser& p_prsr ) : m_lcl(p_prsr.m_lcl) {}
+                Parser( const Parser& p_prsr ) : m_lcl(p_prsr.m_lcl), m_pthLmt(p_prsr.m_pthLmt), m_cch(p_prsr.m_cch) {}
 
                 /**
                  * @brief Default constructor.
@@ -511,73 +714,236 @@ namespace Wintermute {
 
                 /**
                  * @brief Changes the locale of the Parser.
+                 *
+                 * The locale can't be changed while the Parser is parsing; such a request
+                 * is ignored (with a warning) so the parse in progress stays consistent.
+                 *
                  * @fn setLocale
                  * @param p_lcl The locale to be used by the Parser.
-                 * @todo Prevent this value from being changed while parsing's active; it can cause malformed data to be generated.
+                 * @see ParserPool
                  */
                 void setLocale ( const QString& = Wintermute::Data::Linguistics::System::locale ());
 
+                /**
+                 * @brief Obtains the number of paths formed into meanings for each sentence.
+                 * @fn pathLimit
+                 * @return The limit, or 0 if every path is used.
+                 */
+                inline const PathIndex pathLimit() const { return m_pthLmt; }
+
+                /**
+                 * @brief Limits the number of paths formed into meanings for each sentence.
+                 *
+                 * Only the first paths of a sentence's PathSpace are tried; a limit of 1
+                 * is the cheapest way to get a meaning out of a sentence.
+                 *
+                 * @fn setPathLimit
+                 * @param p_lmt The limit, or 0 to use every path.
+                 */
+                inline void setPathLimit ( const PathIndex& p_lmt = 0 ) { m_pthLmt = p_lmt; }
+
+                /**
+                 * @brief Obtains the ResultCache consulted before each sentence is parsed.
+                 * @fn resultCache
+                 */
+                inline ResultCache* resultCache() const { return m_cch; }
+
+                /**
+                 * @brief Changes the ResultCache consulted before each sentence is parsed.
+                 *
+                 * A sentence found in the cache isn't tokenized, looked up or linked at
+                 * all; its result is taken from the cache. Only sentences parsed in full
+                 * (with no path limit, and not called off) are added to it.
+                 *
+                 * @fn setResultCache
+                 * @param p_cch The cache, or NULL to parse every sentence.
+                 */
+                inline void setResultCache ( ResultCache* p_cch = NULL ) { m_cch = p_cch; }
+
+                /**
+                 * @brief Obtains the result of each sentence of the last text given to parse ( const QString&, const CancelToken* ).
+                 * @fn results
+                 */
+                inline const QVector<QByteArray>& results() const { return m_ctx.results (); }
+
+                /**
+                 * @brief Obtains the Parser's own ParseContext, used by parse ( const QString&, const CancelToken* ).
+                 * @fn context
+                 */
+                inline const ParseContext* context() const { return &m_ctx; }
+
                 /**
                  * @brief Parses user text into a semantic representation of its underlying meaning.
+                 *
+                 * The token, if any, is polled between each token, word, path and round
+                 * of linking; once it expires the parse stops where it is and keeps the
+                 * meanings formed up to then.
+                 *
+                 * The Parser's own ParseContext is used, so only one such parse can run
+                 * on a Parser at a time.
+                 *
+                 * A text of more than one sentence is parsed in two stages: the sentences
+                 * are tokenized, looked up and expanded on a worker thread, a couple of
+                 * sentences ahead of the calling thread, which forms their meanings. The
+                 * lookups of one sentence thus overlap the linking of the one before it.
+                 *
                  * @fn parse
                  * @param p_txt The text to be parsed.
+                 * @param p_tkn The CancelToken to heed, or NULL to parse the whole text.
+                 * @return How far the parse got.
                  */
-                void parse ( const QString& );
+                const Status parse ( const QString&, const CancelToken* = NULL );
+
+                /**
+                 * @brief Parses user text within the ParseContext given.
+                 *
+                 * All of the state of the parse is kept in the context, which is reset
+                 * once the parse is done; any number of parses with their own context
+                 * can run on the same Parser at once.
+                 *
+                 * @fn parse
+                 * @param p_ctx The ParseContext to parse in; its CancelToken is heeded.
+                 * @param p_txt The text to be parsed.
+                 * @return How far the parse got.
+                 */
+                const Status parse ( ParseContext&, const QString& );
 
             protected:
                 mutable QString m_lcl;
-                int m_prg;
-                int m_prgMax;
+                QAtomicInt m_actv;
+                PathIndex m_pthLmt;
+                ResultCache* m_cch;
+                SentenceSegmenter m_sgmntr;
+                ParseContext m_ctx;
 
             private:
+                friend class LookupStage;
+
+                /**
+                 * @brief Takes the result of each sentence found in the ResultCache.
+                 * @fn lookupResults
+                 * @param p_ctx The ParseContext of the parse; its sentences are already segmented.
+                 * @param p_txt The text being parsed.
+                 */
+                void lookupResults ( ParseContext&, const QString& );
+
+                /**
+                 * @brief Records the result of a sentence, and remembers it in the ResultCache if it's whole.
+                 * @fn recordResult
+                 * @param p_ctx The ParseContext of the parse.
+                 * @param p_indx The index of the sentence.
+                 * @param p_mng The best Meaning formed from the sentence, or NULL.
+                 */
+                void recordResult ( ParseContext&, const int&, const Meaning* );
+
+                /**
+                 * @brief Obtains the result of a sentence from its best Meaning.
+                 * @fn resultOf
+                 * @param p_mng The Meaning, or NULL.
+                 * @return The binary form of the Meaning (see MeaningEncoding), or an empty QByteArray.
+                 */
+                static const QByteArray resultOf ( const Meaning* );
+
+                /**
+                 * @brief Announces how far the parse got, at most once per 50 ms unless forced.
+                 * @fn reportProgress
+                 * @param p_ctx The ParseContext of the parse.
+                 * @param p_frc true to announce it regardless of when it was last announced.
+                 * @see progressed()
+                 */
+                void reportProgress ( ParseContext&, const bool& = false );
+
+                /**
+                 * @brief Parses the sentences of a text with their lookups and their linking overlapped.
+                 * @fn parseStaged
+                 * @param p_ctx The ParseContext of the parse; its sentences are already segmented.
+                 * @param p_txt The text being parsed.
+                 * @param p_mngVtr Filled with the Meaning formed from each sentence.
+                 * @see LookupStage
+                 */
+                void parseStaged ( ParseContext&, const QString&, MeaningList& );
+
+                /**
+                 * @brief Tokenizes, looks up and expands a sentence, leaving its paths in the ParseContext.
+                 * @fn lookup
+                 * @param p_ctx The ParseContext of the parse.
+                 * @param p_txt The text being parsed.
+                 * @param p_sntnc The range of the sentence within @c p_txt.
+                 */
+                void lookup ( ParseContext&, const QString&, const SentenceRange& );
+
+                /**
+                 * @brief Forms the Meaning objects of the paths left in the ParseContext by lookup().
+                 * @fn formMeanings
+                 * @param p_ctx The ParseContext of the parse.
+                 * @return The best Meaning formed from the paths tried, or NULL.
+                 */
+                const Meaning* formMeanings ( ParseContext& );
 
                 /**
-                 * @brief Processes the text for parsing.
+                 * @brief Processes a sentence of the text for parsing.
                  * @fn process
-                 * @param p_txt The text to be parsed.
+                 * @param p_ctx The ParseContext of the parse.
+                 * @param p_txt The text being parsed.
+                 * @param p_sntnc The range of the sentence within @c p_txt.
+                 * @return The best Meaning formed from the paths tried, or NULL.
                  */
-                const Meaning* process ( const QString& );
+                const Meaning* process ( ParseContext&, const QString&, const SentenceRange& );
 
                 /**
-                 * @brief Breaks up the text into tokens to be used by the parser.
+                 * @brief Breaks up a sentence into tokens to be used by the parser.
                  * @fn getTokens
-                 * @param p_txt The text to be broken up.
-                 * @todo Return TokenList instead of QStringList.
+                 * @param p_ctx The ParseContext of the parse; once it has expired no tokens are formed.
+                 * @param p_txt The text being parsed.
+                 * @param p_sntnc The range of the sentence within @c p_txt.
+                 * @return The context's TokenStore, holding ranges into @c p_txt.
                  */
-                QStringList getTokens ( const QString & );
+                const TokenStore& getTokens ( ParseContext&, const QString &, const SentenceRange& );
 
                 /**
                  * @brief Forms a Node from the text specified.
                  * @fn formNode
+                 * @param p_ctx The ParseContext of the parse.
                  * @param p_ndTxt The symbolic representation of a Node.
                  * @todo Use Token instead of QString.
                  */
-                Node* formNode( const QString& );
+                Node* formNode( ParseContext&, const QString& );
 
                 /**
-                 * @brief Generates a list of Nodes from the list of tokens specified.
+                 * @brief Generates a list of Nodes from the tokens specified.
+                 *
+                 * Each token yields a Node for its symbol, followed by a Node for
+                 * the full form of its suffix when the locale knows one.
+                 *
                  * @fn formNodes
-                 * @param p_txtLst The list of tokens to be Node-ified.
+                 * @param p_ctx The ParseContext of the parse; checked before each token's lookups.
+                 * @param p_tokens The tokens to be Node-ified.
                  * @see formNode
-                 * @todo Use TokenList instead of QStringList.
                  */
-                NodeList formNodes ( const QStringList& );
+                NodeList formNodes ( ParseContext&, const TokenStore& );
 
                 /**
-                 * @brief
+                 * @brief Expands a sentence's Node objects into the space of paths they can form.
+                 *
+                 * The variants of each word are kept by the ParseContext; a path is addressed
+                 * by its PathIndex and decoded into NodeCode objects pointing back at them.
+                 *
                  * @fn expandNodes
-                 * @param
+                 * @param p_ctx The ParseContext of the parse; checked before each word is expanded.
+                 * @param p_baseNodeVtr The Node objects formed by formNodes().
+                 * @return The context's PathSpace for the sentence; empty if the context expired.
+                 * @see nodesOf
                  */
-                NodeTree expandNodes ( NodeList const & );
+                const PathSpace& expandNodes ( ParseContext&, NodeList const & );
 
                 /**
-                 * @brief
-                 * @fn expandNodes
-                 * @param
-                 * @param
-                 * @param
+                 * @brief Obtains the Node objects that a path of NodeCode objects stands for.
+                 * @fn nodesOf
+                 * @param p_ctx The ParseContext the path was formed in.
+                 * @param p_path A path formed by expandNodes().
                  */
-                NodeTree expandNodes ( NodeTree& , const int& = 0, const int& = 0 );
+                const NodeList nodesOf ( const ParseContext&, const NodeCodeList& ) const;
+
                 /**
                  * @brief
                  * @fn formMeaning
@@ -592,7 +958,7 @@ namespace Wintermute {
                  */
                 static const QString formShorthand ( const NodeList& , const Node::FormatVerbosity& = Node::FULL );
 
-                void doUnwindingProgressStep();
+                void doUnwindingProgressStep( ParseContext& );
 
             signals:
                 /**
@@ -622,6 +988,23 @@ namespace Wintermute {
                  * @fn finishedMeaningForming
                  */
                 void finishedMeaningForming();
+
+                /**
+                 * @brief Emitted every so often while the paths of a sentence are tried.
+                 *
+                 * Trying a path enumerates it and forms its Meaning, so this covers both.
+                 * The remaining time only accounts for the paths of the current sentence;
+                 * those of later sentences aren't known until they're expanded.
+                 *
+                 * Parses that run at once on the same Parser are told apart by their context.
+                 *
+                 * @fn progressed
+                 * @param p_ctx The ParseContext of the parse in question.
+                 * @param p_frctn The fraction of the text done, from 0.0 to 1.0.
+                 * @param p_rt The paths tried per second so far in the current sentence.
+                 * @param p_eta The estimated time left for the current sentence in milliseconds, or -1 if unknown.
+                 */
+                void progressed(const ParseContext*, const double&, const double&, const qint64&);
         };
     }
 }
@@ -0,0 +1,84 @@
+/**
+ * @file    paths.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 8:20 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "paths.hpp"
+#include "logging.hpp"
+
+namespace Wintermute {
+    namespace Linguistics {
+        PathSpace::PathSpace() : m_wrds(), m_cnt(1), m_str(false) { }
+
+        void PathSpace::clear() {
+            // Keep the storage for the next sentence; clear() would free it.
+            m_wrds.reserve ( m_wrds.capacity () );
+            m_wrds.resize ( 0 );
+            m_cnt = 1;
+            m_str = false;
+        }
+
+        void PathSpace::append ( const NodeCodeList& p_vrnts ) {
+            const PathIndex l_rdx = p_vrnts.size ();
+            const PathIndex l_max = ~PathIndex ( 0 );
+
+            m_wrds << p_vrnts;
+
+            if ( l_rdx == 0 ) {
+                lingWarning ( "PathSpace" ) << "Null data detected at level" << ( m_wrds.size () - 1 ) << ".";
+                m_cnt = 0;
+            } else if ( m_cnt > l_max / l_rdx ) {
+                if ( !m_str )
+                    lingWarning ( "PathSpace" ) << "Too many paths to address; only the first" << l_max << "can be reached.";
+
+                m_cnt = l_max;
+                m_str = true;
+            } else
+                m_cnt *= l_rdx;
+        }
+
+        void PathSpace::decode ( const PathIndex& p_indx, NodeCodeList& p_path ) const {
+            Q_ASSERT ( p_indx < count () );
+            PathIndex l_rmndr = p_indx;
+
+            p_path.resize ( m_wrds.size () );
+
+            for ( int l_wrd = m_wrds.size () - 1; l_wrd >= 0; l_wrd-- ) {
+                const NodeCodeList& l_vrnts = m_wrds.at ( l_wrd );
+                const PathIndex l_rdx = l_vrnts.size ();
+
+                p_path[l_wrd] = l_vrnts.at ( l_rmndr % l_rdx );
+                l_rmndr /= l_rdx;
+            }
+        }
+
+        const PathIndex PathSpace::encode ( const NodeCodeList& p_path ) const {
+            Q_ASSERT ( p_path.size () == m_wrds.size () );
+            PathIndex l_indx = 0;
+
+            for ( int l_wrd = 0; l_wrd < p_path.size (); l_wrd++ )
+                l_indx = l_indx * m_wrds.at ( l_wrd ).size () + p_path.at ( l_wrd ).m_vrnt;
+
+            return l_indx;
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,127 @@
+/**
+ * @file    paths.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 8:20 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __PATHS_HPP__
+#define __PATHS_HPP__
+
+#include <QVector>
+#include "syntax.hpp"
+
+namespace Wintermute {
+    namespace Linguistics {
+        /**
+         * @brief Represents a path of a sentence as a single number.
+         * @see PathSpace
+         * @typedef PathIndex
+         */
+        typedef quint64 PathIndex;
+
+        /**
+         * @brief The set of paths that a sentence expands into, addressed by number.
+         *
+         * Each word of a sentence contributes one of its variants to a path, so the
+         * paths form a mixed-radix number system: the radix of each digit is the
+         * number of variants of that word, the first word being the most significant.
+         * For "We are boys" (with 4, 2 and 1 variants), path 5 is digits (2, 1, 0);
+         * the third variant of "We", the second of "are" and the only one of "boys".
+         *
+         * Rather than holding every path, a PathSpace only holds the variants of each
+         * word and decodes a path from its PathIndex when asked. Any path can then be
+         * addressed, handed out in ranges or logged as one number, while the memory
+         * needed stays proportional to the length of the sentence.
+         *
+         * @note Should the number of paths not fit a PathIndex, count() saturates and
+         *       only the paths below it can be addressed.
+         * @class PathSpace paths.hpp "src/paths.hpp"
+         */
+        class PathSpace {
+            public:
+                /**
+                 * @brief Null constructor; an empty space holding no paths.
+                 * @fn PathSpace
+                 */
+                PathSpace();
+
+                /**
+                 * @brief Empties the space.
+                 * @fn clear
+                 */
+                void clear();
+
+                /**
+                 * @brief Appends a word to the space, as the least significant digit.
+                 * @fn append
+                 * @param p_vrnts The NodeCode objects of the word's variants.
+                 */
+                void append ( const NodeCodeList& );
+
+                /**
+                 * @brief Obtains the number of paths in the space.
+                 * @fn count
+                 * @return The product of every word's variant count, or 0 if there are no words.
+                 */
+                inline const PathIndex count() const { return m_wrds.isEmpty () ? 0 : m_cnt; }
+
+                /**
+                 * @brief Determines if the number of paths had to be saturated.
+                 * @fn isSaturated
+                 */
+                inline const bool isSaturated() const { return m_str; }
+
+                /**
+                 * @brief Obtains the number of words in each path.
+                 * @fn length
+                 */
+                inline const int length() const { return m_wrds.size (); }
+
+                /**
+                 * @brief Obtains the variants of a word.
+                 * @fn variants
+                 * @param p_wrd The index of the word.
+                 */
+                inline const NodeCodeList& variants ( const int& p_wrd ) const { return m_wrds.at ( p_wrd ); }
+
+                /**
+                 * @brief Decodes a path.
+                 * @fn decode
+                 * @param p_indx The index of the path; it must be lower than count().
+                 * @param p_path The list to fill; its storage is reused.
+                 */
+                void decode ( const PathIndex&, NodeCodeList& ) const;
+
+                /**
+                 * @brief Encodes a path into its index.
+                 * @fn encode
+                 * @param p_path A path of this space, such as one filled by decode().
+                 */
+                const PathIndex encode ( const NodeCodeList& ) const;
+
+            private:
+                QVector<NodeCodeList> m_wrds;
+                PathIndex m_cnt;
+                bool m_str;
+        };
+    }
+}
+
+#endif /* __PATHS_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,147 @@
+/**
+ * @file    pipeline.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 19, 2026 1:15 AM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __PIPELINE_HPP__
+#define __PIPELINE_HPP__
+
+#include <QQueue>
+#include <QMutex>
+#include <QVector>
+#include <QWaitCondition>
+#include "syntax.hpp"
+#include "paths.hpp"
+
+namespace Wintermute {
+    namespace Linguistics {
+        /**
+         * @brief Represents a sentence that's been looked up and is ready to be linked.
+         *
+         * It carries the index of the sentence within its text, the variants of each
+         * of its words and the PathSpace they form, as left by Parser::expandNodes();
+         * the last two are implicitly shared, so handing one over copies nothing.
+         *
+         * @see StageQueue
+         * @class StagedSentence pipeline.hpp "src/pipeline.hpp"
+         */
+        struct StagedSentence {
+            int m_indx;
+            QVector<NodeList> m_vrnts;
+            PathSpace m_pths;
+        };
+
+        /**
+         * @brief Hands work from one stage of a parse to the next.
+         *
+         * The queue holds a bounded number of items: the producing stage waits while
+         * it's full and the consuming stage waits while it's empty, so neither stage
+         * can run off ahead of the other. The producer close()s the queue when it has
+         * nothing more to give; the consumer abort()s it when it wants nothing more,
+         * which frees a producer waiting for room.
+         *
+         * @class StageQueue pipeline.hpp "src/pipeline.hpp"
+         */
+        template<typename T>
+        class StageQueue {
+            Q_DISABLE_COPY(StageQueue)
+
+            public:
+                /**
+                 * @brief Default constructor.
+                 * @fn StageQueue
+                 * @param p_cpcty The most items held at once.
+                 */
+                explicit StageQueue ( const int& p_cpcty = 2 ) : m_cpcty ( qMax ( 1, p_cpcty ) ), m_clsd ( false ), m_abrtd ( false ) { }
+
+                /**
+                 * @brief Adds an item, waiting for room if the queue is full.
+                 * @fn push
+                 * @param p_itm The item.
+                 * @return false if the queue was aborted; the item is dropped.
+                 */
+                bool push ( const T& p_itm ) {
+                    QMutexLocker l_lck ( &m_lck );
+                    while ( m_itms.size () >= m_cpcty && !m_abrtd )
+                        m_notFull.wait ( &m_lck );
+
+                    if ( m_abrtd )
+                        return false;
+
+                    m_itms.enqueue ( p_itm );
+                    m_notEmpty.wakeOne ();
+                    return true;
+                }
+
+                /**
+                 * @brief Takes the oldest item, waiting for one if the queue is empty.
+                 * @fn pop
+                 * @param p_itm Set to the item taken.
+                 * @return false once the queue is closed and drained, or aborted.
+                 */
+                bool pop ( T& p_itm ) {
+                    QMutexLocker l_lck ( &m_lck );
+                    while ( m_itms.isEmpty () && !m_clsd && !m_abrtd )
+                        m_notEmpty.wait ( &m_lck );
+
+                    if ( m_abrtd || m_itms.isEmpty () )
+                        return false;
+
+                    p_itm = m_itms.dequeue ();
+                    m_notFull.wakeOne ();
+                    return true;
+                }
+
+                /**
+                 * @brief Marks that no more items will be pushed.
+                 * @fn close
+                 */
+                void close() {
+                    QMutexLocker l_lck ( &m_lck );
+                    m_clsd = true;
+                    m_notEmpty.wakeAll ();
+                }
+
+                /**
+                 * @brief Drops every item and turns away any more.
+                 * @fn abort
+                 */
+                void abort() {
+                    QMutexLocker l_lck ( &m_lck );
+                    m_abrtd = true;
+                    m_itms.clear ();
+                    m_notFull.wakeAll ();
+                    m_notEmpty.wakeAll ();
+                }
+
+            private:
+                QMutex m_lck;
+                QWaitCondition m_notEmpty;
+                QWaitCondition m_notFull;
+                QQueue<T> m_itms;
+                const int m_cpcty;
+                bool m_clsd;
+                bool m_abrtd;
+        };
+    }
+}
+
+#endif /* __PIPELINE_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
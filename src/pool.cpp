@@ -0,0 +1,69 @@
+/**
+ * @file    pool.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 8:55 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "pool.hpp"
+#include "parser.hpp"
+#include "logging.hpp"
+
+namespace Wintermute {
+    namespace Linguistics {
+        ParserPool::ParserPool() : m_idl(), m_lck() { }
+
+        ParserPool::~ParserPool() { clear (); }
+
+        Parser* ParserPool::acquire ( const QString& p_lcl ) {
+            {
+                QMutexLocker l_lck ( &m_lck );
+                QHash<QString, QList<Parser*> >::Iterator l_itr = m_idl.find ( p_lcl );
+                if ( l_itr != m_idl.end () && !l_itr.value ().isEmpty () )
+                    return l_itr.value ().takeLast ();
+            }
+
+            lingDebug ( "ParserPool" ) << "Forming a new parser for" << p_lcl;
+            return new Parser ( p_lcl );
+        }
+
+        void ParserPool::release ( Parser* p_prs ) {
+            if ( !p_prs )
+                return;
+
+            QMutexLocker l_lck ( &m_lck );
+            m_idl[p_prs->locale ()] << p_prs;
+        }
+
+        const int ParserPool::idleCount ( const QString& p_lcl ) const {
+            QMutexLocker l_lck ( &m_lck );
+            return m_idl.value ( p_lcl ).size ();
+        }
+
+        void ParserPool::clear() {
+            QMutexLocker l_lck ( &m_lck );
+
+            foreach ( const QList<Parser*>& l_prsrs, m_idl )
+                qDeleteAll ( l_prsrs );
+
+            m_idl.clear ();
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,100 @@
+/**
+ * @file    pool.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 8:55 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __POOL_HPP__
+#define __POOL_HPP__
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+namespace Wintermute {
+    namespace Linguistics {
+        class Parser;
+
+        /**
+         * @brief Keeps idle Parser objects around, one set per locale.
+         *
+         * A Parser is bound to the locale it was formed with and is only ever used
+         * by one request at a time. The pool hands out a Parser of the requested
+         * locale, forming one if none is idle, and takes it back once the request is
+         * done; requests in different locales never share a Parser (or the storage it
+         * has grown), and a Parser never has its locale changed under it.
+         *
+         * The pool is safe to use from any thread.
+         *
+         * @class ParserPool pool.hpp "src/pool.hpp"
+         */
+        class ParserPool {
+            Q_DISABLE_COPY(ParserPool)
+
+            public:
+                /**
+                 * @brief Null constructor.
+                 * @fn ParserPool
+                 */
+                ParserPool();
+
+                /**
+                 * @brief Deconstructor; deletes every idle Parser.
+                 * @fn ~ParserPool
+                 */
+                ~ParserPool();
+
+                /**
+                 * @brief Takes an idle Parser for a locale, or forms a new one.
+                 * @fn acquire
+                 * @param p_lcl The locale the Parser has to use.
+                 * @return A Parser that belongs to the caller until it's handed to release().
+                 */
+                Parser* acquire ( const QString& );
+
+                /**
+                 * @brief Hands a Parser back to the pool.
+                 * @fn release
+                 * @param p_prs A Parser obtained from acquire().
+                 */
+                void release ( Parser* );
+
+                /**
+                 * @brief Obtains the number of idle Parser objects for a locale.
+                 * @fn idleCount
+                 * @param p_lcl The locale in question.
+                 */
+                const int idleCount ( const QString& ) const;
+
+                /**
+                 * @brief Deletes every idle Parser.
+                 * @fn clear
+                 */
+                void clear();
+
+            private:
+                QHash<QString, QList<Parser*> > m_idl;
+                mutable QMutex m_lck;
+        };
+    }
+}
+
+#endif /* __POOL_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
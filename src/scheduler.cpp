@@ -0,0 +1,213 @@
+/**
+ * @file    scheduler.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 9:30 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "scheduler.hpp"
+#include "logging.hpp"
+#include <QThread>
+
+namespace Wintermute {
+    namespace Linguistics {
+        ScheduledJob::ScheduledJob() : QRunnable(), m_schd(NULL), m_clnt(), m_prty(Scheduler::Normal), m_dgrdd(false) { }
+
+        void ScheduledJob::run() {
+            execute ();
+
+            if ( m_schd )
+                m_schd->finish ( this );
+        }
+
+        Scheduler::Scheduler ( const int& p_qLmt, const int& p_clntLmt ) : m_pool(), m_lck(), m_btchs(), m_btchRnng ( 0 ), m_clnts(),
+            m_qLmt ( qMax ( 1, p_qLmt ) ), m_clntLmt ( qMax ( 1, p_clntLmt ) ), m_cmpltd ( 0 ) {
+            m_pool.setMaxThreadCount ( QThread::idealThreadCount () );
+
+            for ( int l_i = 0; l_i <= Interactive; l_i++ )
+                m_inFlght[l_i] = 0;
+
+            for ( int l_i = 0; l_i <= RejectedClientLimit; l_i++ )
+                m_cnts[l_i] = 0;
+        }
+
+        Scheduler::~Scheduler() { waitForDone (); }
+
+        const Scheduler::Decision Scheduler::decide ( const QString& p_clnt, const Priority& p_prty ) const {
+            if ( m_clnts.value ( p_clnt, 0 ) >= m_clntLmt )
+                return RejectedClientLimit;
+
+            int l_inFlght = 0;
+            for ( int l_i = 0; l_i <= Interactive; l_i++ )
+                l_inFlght += m_inFlght[l_i];
+
+            const int l_soft = ( m_qLmt * 3 ) / 4;
+
+            switch ( p_prty ) {
+            case Batch:
+                return l_inFlght >= l_soft ? RejectedQueueFull : Admitted;
+
+            case Interactive:
+                if ( l_inFlght < m_qLmt ) return Admitted;
+                return l_inFlght < m_qLmt + m_pool.maxThreadCount () ? Degraded : RejectedQueueFull;
+
+            default:
+            case Normal:
+                if ( l_inFlght >= m_qLmt ) return RejectedQueueFull;
+                return l_inFlght >= l_soft ? Degraded : Admitted;
+            }
+        }
+
+        const Scheduler::Decision Scheduler::submit ( ScheduledJob* p_job, const QString& p_clnt, const Priority& p_prty ) {
+            Decision l_dcsn;
+
+            {
+                QMutexLocker l_lck ( &m_lck );
+                l_dcsn = decide ( p_clnt, p_prty );
+                m_cnts[l_dcsn]++;
+
+                if ( l_dcsn == Admitted || l_dcsn == Degraded ) {
+                    m_clnts[p_clnt]++;
+                    m_inFlght[p_prty]++;
+                }
+            }
+
+            if ( l_dcsn != Admitted && l_dcsn != Degraded ) {
+                lingWarning ( "Scheduler" ) << "Rejected a request from" << p_clnt << ":" << describe ( l_dcsn );
+                delete p_job;
+                return l_dcsn;
+            }
+
+            p_job->m_schd = this;
+            p_job->m_clnt = p_clnt;
+            p_job->m_prty = p_prty;
+            p_job->m_dgrdd = ( l_dcsn == Degraded );
+            p_job->setAutoDelete ( true );
+
+            if ( p_prty == Batch ) {
+                {
+                    QMutexLocker l_lck ( &m_lck );
+                    m_btchs.enqueue ( p_job );
+                }
+
+                startBatches ();
+            } else
+                m_pool.start ( p_job, p_prty );
+
+            return l_dcsn;
+        }
+
+        void Scheduler::startBatches() {
+            QMutexLocker l_lck ( &m_lck );
+            const int l_lmt = batchLimit ();
+
+            while ( !m_btchs.isEmpty () && m_btchRnng < l_lmt ) {
+                m_btchRnng++;
+                m_pool.start ( m_btchs.dequeue (), Batch );
+            }
+        }
+
+        void Scheduler::finish ( ScheduledJob* p_job ) {
+            {
+                QMutexLocker l_lck ( &m_lck );
+                m_inFlght[p_job->m_prty]--;
+                m_cmpltd++;
+
+                if ( p_job->m_prty == Batch )
+                    m_btchRnng--;
+
+                QHash<QString, int>::Iterator l_itr = m_clnts.find ( p_job->m_clnt );
+                if ( l_itr != m_clnts.end () && --l_itr.value () <= 0 )
+                    m_clnts.erase ( l_itr );
+            }
+
+            if ( p_job->m_prty == Batch )
+                startBatches ();
+        }
+
+        const int Scheduler::workerCount() const {
+            return m_pool.maxThreadCount ();
+        }
+
+        void Scheduler::setWorkerCount ( const int& p_cnt ) {
+            m_pool.setMaxThreadCount ( qMax ( 1, p_cnt ) );
+            startBatches ();
+        }
+
+        const int Scheduler::batchLimit() const {
+            return qMax ( 1, m_pool.maxThreadCount () - 1 );
+        }
+
+        void Scheduler::setQueueLimit ( const int& p_lmt ) {
+            QMutexLocker l_lck ( &m_lck );
+            m_qLmt = qMax ( 1, p_lmt );
+        }
+
+        void Scheduler::setClientLimit ( const int& p_lmt ) {
+            QMutexLocker l_lck ( &m_lck );
+            m_clntLmt = qMax ( 1, p_lmt );
+        }
+
+        void Scheduler::waitForDone() {
+            m_pool.waitForDone ();
+        }
+
+        const QVariantMap Scheduler::metrics() const {
+            QMutexLocker l_lck ( &m_lck );
+            QVariantMap l_mtrcs;
+
+            l_mtrcs.insert ( "admitted", m_cnts[Admitted] );
+            l_mtrcs.insert ( "degraded", m_cnts[Degraded] );
+            l_mtrcs.insert ( "rejected", m_cnts[RejectedQueueFull] + m_cnts[RejectedClientLimit] );
+            l_mtrcs.insert ( "rejectedQueueFull", m_cnts[RejectedQueueFull] );
+            l_mtrcs.insert ( "rejectedClientLimit", m_cnts[RejectedClientLimit] );
+            l_mtrcs.insert ( "completed", m_cmpltd );
+            l_mtrcs.insert ( "inFlightBatch", m_inFlght[Batch] );
+            l_mtrcs.insert ( "inFlightNormal", m_inFlght[Normal] );
+            l_mtrcs.insert ( "inFlightInteractive", m_inFlght[Interactive] );
+            l_mtrcs.insert ( "queueLimit", m_qLmt );
+            l_mtrcs.insert ( "clientLimit", m_clntLmt );
+            l_mtrcs.insert ( "workers", m_pool.maxThreadCount () );
+            l_mtrcs.insert ( "runningBatch", m_btchRnng );
+            l_mtrcs.insert ( "waitingBatch", m_btchs.size () );
+            l_mtrcs.insert ( "batchLimit", batchLimit () );
+
+            return l_mtrcs;
+        }
+
+        const QString Scheduler::describe ( const Decision& p_dcsn ) {
+            switch ( p_dcsn ) {
+            case Admitted:
+                return "Admitted.";
+
+            case Degraded:
+                return "Admitted in the cheaper parsing mode; the system is busy.";
+
+            case RejectedQueueFull:
+                return "Rejected; too many requests are waiting to be parsed.";
+
+            case RejectedClientLimit:
+                return "Rejected; this client has too many requests in flight.";
+            }
+
+            return QString();
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
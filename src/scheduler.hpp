@@ -0,0 +1,238 @@
+/**
+ * @file    scheduler.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 9:30 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __SCHEDULER_HPP__
+#define __SCHEDULER_HPP__
+
+#include <QHash>
+#include <QQueue>
+#include <QMutex>
+#include <QString>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QVariantMap>
+
+namespace Wintermute {
+    namespace Linguistics {
+        class Scheduler;
+
+        /**
+         * @brief A unit of work run by a Scheduler.
+         *
+         * Subclasses implement execute(); the Scheduler tells them through isDegraded()
+         * whether they were admitted in the cheaper parsing mode.
+         *
+         * @class ScheduledJob scheduler.hpp "src/scheduler.hpp"
+         */
+        class ScheduledJob : public QRunnable {
+            friend class Scheduler;
+
+            public:
+                /**
+                 * @brief Null constructor.
+                 * @fn ScheduledJob
+                 */
+                ScheduledJob();
+
+                /**
+                 * @brief Determines if the job has to use the cheaper parsing mode.
+                 * @fn isDegraded
+                 */
+                inline const bool isDegraded() const { return m_dgrdd; }
+
+                /**
+                 * @brief Obtains the client the job is run for.
+                 * @fn client
+                 */
+                inline const QString client() const { return m_clnt; }
+
+                /**
+                 * @brief Runs the job and tells the Scheduler it's done.
+                 * @fn run
+                 */
+                virtual void run();
+
+            protected:
+                /**
+                 * @brief Does the work of the job.
+                 * @fn execute
+                 */
+                virtual void execute() = 0;
+
+            private:
+                Scheduler* m_schd;
+                QString m_clnt;
+                int m_prty;
+                bool m_dgrdd;
+        };
+
+        /**
+         * @brief Decides which parse requests run, in what order and how thoroughly.
+         *
+         * Every request falls in a priority class. Admitted jobs wait in a bounded
+         * queue, the most urgent class first, for one of the Scheduler's worker threads.
+         * As the queue fills, requests are admitted in a cheaper mode (which parses only
+         * the first path of each sentence) or rejected outright:
+         *
+         * @li Batch requests are rejected once the queue is three-quarters full.
+         * @li Normal requests are degraded once the queue is three-quarters full and rejected once it's full.
+         * @li Interactive requests are degraded once the queue is full and can overflow it by one
+         *     request per worker thread before they're rejected.
+         *
+         * A client can't have more than a set number of requests waiting or running at
+         * once; further requests are rejected. Every decision is counted in metrics().
+         *
+         * Batch requests never occupy every worker thread: all but one worker (at least
+         * one) may run them, and further Batch jobs wait in the Scheduler until one of
+         * them is done. However long a batch flood runs, a worker stays free for
+         * Interactive and Normal requests.
+         *
+         * @class Scheduler scheduler.hpp "src/scheduler.hpp"
+         */
+        class Scheduler {
+            Q_DISABLE_COPY(Scheduler)
+
+            public:
+                /**
+                 * @brief The priority classes of requests.
+                 * @enum Priority
+                 */
+                enum Priority {
+                    Batch = 0, /**< Bulk work; first to be turned away. */
+                    Normal, /**< The default. */
+                    Interactive /**< Someone's waiting on the answer. */
+                };
+
+                /**
+                 * @brief The outcome of submitting a job.
+                 * @enum Decision
+                 */
+                enum Decision {
+                    Admitted = 0, /**< The job was queued as is. */
+                    Degraded, /**< The job was queued in the cheaper parsing mode. */
+                    RejectedQueueFull, /**< The job was dropped; too much work is queued. */
+                    RejectedClientLimit /**< The job was dropped; its client has too many requests in flight. */
+                };
+
+                /**
+                 * @brief Default constructor.
+                 * @fn Scheduler
+                 * @param p_qLmt The number of jobs that can wait or run at once.
+                 * @param p_clntLmt The number of jobs a single client can have waiting or running at once.
+                 */
+                explicit Scheduler ( const int& = 256, const int& = 32 );
+
+                /**
+                 * @brief Deconstructor; waits for every admitted job to finish.
+                 * @fn ~Scheduler
+                 */
+                ~Scheduler();
+
+                /**
+                 * @brief Submits a job.
+                 * @fn submit
+                 * @param p_job The job; the Scheduler takes ownership of it, deleting it if it's rejected.
+                 * @param p_clnt The client the job is run for.
+                 * @param p_prty The Priority of the job.
+                 * @return The Decision made for the job.
+                 */
+                const Decision submit ( ScheduledJob*, const QString&, const Priority& = Normal );
+
+                /**
+                 * @brief Obtains the number of worker threads.
+                 * @fn workerCount
+                 */
+                const int workerCount() const;
+
+                /**
+                 * @brief Changes the number of worker threads.
+                 * @fn setWorkerCount
+                 * @param p_cnt The number of threads.
+                 */
+                void setWorkerCount ( const int& );
+
+                /**
+                 * @brief Obtains the number of Batch jobs that may run at once.
+                 * @fn batchLimit
+                 */
+                const int batchLimit() const;
+
+                /**
+                 * @brief Changes the number of jobs that can wait or run at once.
+                 * @fn setQueueLimit
+                 * @param p_lmt The new limit.
+                 */
+                void setQueueLimit ( const int& );
+
+                /**
+                 * @brief Changes the number of jobs a single client can have waiting or running at once.
+                 * @fn setClientLimit
+                 * @param p_lmt The new limit.
+                 */
+                void setClientLimit ( const int& );
+
+                /**
+                 * @brief Waits for every admitted job to finish.
+                 * @fn waitForDone
+                 */
+                void waitForDone();
+
+                /**
+                 * @brief Obtains the counters of the Scheduler.
+                 *
+                 * The map holds the number of jobs admitted, degraded, rejected (in total and
+                 * for each reason) and completed, along with the number in flight for each
+                 * priority class and the current limits.
+                 *
+                 * @fn metrics
+                 */
+                const QVariantMap metrics() const;
+
+                /**
+                 * @brief Obtains a readable explanation of a Decision.
+                 * @fn describe
+                 * @param p_dcsn The Decision in question.
+                 */
+                static const QString describe ( const Decision& );
+
+            private:
+                friend class ScheduledJob;
+                void finish ( ScheduledJob* );
+                void startBatches();
+                const Decision decide ( const QString&, const Priority& ) const;
+
+                QThreadPool m_pool;
+                mutable QMutex m_lck;
+                QQueue<ScheduledJob*> m_btchs; /**< Admitted Batch jobs waiting for a worker they may use. */
+                int m_btchRnng; /**< The number of Batch jobs handed to the pool. */
+                QHash<QString, int> m_clnts;
+                int m_inFlght[Interactive + 1];
+                int m_qLmt;
+                int m_clntLmt;
+                qulonglong m_cnts[RejectedClientLimit + 1];
+                qulonglong m_cmpltd;
+        };
+    }
+}
+
+#endif /* __SCHEDULER_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -21,27 +21,92 @@
  */
 
 #include "syntax.hpp"
+#include "arena.hpp"
+#include "metrics.hpp"
+#include "logging.hpp"
+#include <QHash>
+#include <QPair>
+#include <QSet>
 #include <QtDebug>
+#include <QMap>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QAtomicInt>
 #include <QtDBus/QDBusMessage>
 #include <QtDBus/QDBusConnection>
 #include <boost/smart_ptr.hpp>
-#include <boost/tokenizer.hpp>
 #include <data/config.hpp>
 #include <data/interfaces.hpp>
 #include <wntr/ipc.hpp>
 
 using namespace boost;
-
-using boost::tokenizer;
 using Wintermute::Data::Linguistics::Lexical::LoadModel;
 using Wintermute::Data::Linguistics::Lexical::SaveModel;
 using Wintermute::Data::Linguistics::Lexical::Storage;
 
 namespace Wintermute {
     namespace Linguistics {
+        namespace {
+            typedef QPair<Atom, QString> ExpansionKey;
+            typedef QHash<ExpansionKey, NodeList> ExpansionCache;
+
+            /// The memoized variants of every (locale, ID) expanded so far.
+            ExpansionCache s_expnsns;
+            QReadWriteLock s_expnsnLck;
+
+            /// Bumped whenever the lexicon is known to have changed.
+            QAtomicInt s_rvsn ( 0 );
+
+            /// Variants dropped from the cache, by the revision they were dropped at, oldest first; guarded by s_expnsnLck.
+            QList<QPair<int, QList<NodeList> > > s_rtrd;
+
+            /// The number of parses pinned at each revision.
+            QMap<int, int> s_pnd;
+            QMutex s_pnLck;
+
+            /**
+             * Deletes the variants no pinned parse can hold; s_expnsnLck has to be held for writing.
+             * A parse pinned at a revision only sees the cache as it was from then on, so whatever
+             * was dropped at or before that revision is out of its reach.
+             */
+            void reclaimExpansions ( ) {
+                int l_oldst;
+                {
+                    QMutexLocker l_lck ( &s_pnLck );
+                    if ( s_pnd.isEmpty () )
+                        l_oldst = s_rvsn;
+                    else
+                        l_oldst = s_pnd.constBegin ().key ();
+                }
+
+                while ( !s_rtrd.isEmpty () && s_rtrd.first ().first <= l_oldst ) {
+                    foreach ( const NodeList& l_vtr, s_rtrd.first ().second )
+                        qDeleteAll ( l_vtr );
+
+                    s_rtrd.removeFirst ();
+                }
+            }
+
+            /// Bumps the revision and retires dropped variants at it; s_expnsnLck has to be held for writing.
+            void retireExpansions ( const QList<NodeList>& p_vtrs ) {
+                const int l_rvsn = s_rvsn.fetchAndAddOrdered ( 1 ) + 1;
+
+                if ( !p_vtrs.isEmpty () )
+                    s_rtrd << qMakePair ( l_rvsn, p_vtrs );
+
+                reclaimExpansions ();
+            }
+
+            /// The fields of a Link read by Link::fromStrings(), its Node objects by key index.
+            struct LinkFields {
+                int m_src;
+                int m_dst;
+                QString m_flgs;
+            };
+        }
 
         const QString Node::toString ( const Node::FormatVerbosity& p_density ) const {
-            QVariantMap::ConstIterator l_flgItr = m_lxdt.flags ().begin ();
+            QVariantMap::ConstIterator l_flgItr = m_flgs.begin ();
             QString sig;
             switch ( p_density ) {
             case MINIMAL:
@@ -80,103 +145,334 @@ namespace Wintermute {
         }
 
         Node* Node::create( const Lexical::Data& p_dt ){
-            qDebug() << "(ling) [Node] Created node for" << p_dt.id() << ".";
-            Data::NodeInterface* l_ndInt = new Data::NodeInterface;
-            QDBusPendingReply<QString> l_replyDt = l_ndInt->write(p_dt);
-            l_replyDt.waitForFinished();
+            lingDebug ( "Node" ) << "Created node for" << p_dt.id() << ".";
+            Data::NodeInterface l_ndInt;
+            QDBusPendingReply<QString> l_replyDt;
+            {
+                StageTimer l_tmr ( Metrics::NodeWrite );
+                l_replyDt = l_ndInt.write(p_dt);
+                l_replyDt.waitForFinished();
+            }
             const Lexical::Data l_dt = Lexical::Data::fromString(l_replyDt);
+            dropExpansion ( p_dt.locale (), p_dt.id () );
+
+            if ( l_dt.locale () != p_dt.locale () || l_dt.id () != p_dt.id () )
+                dropExpansion ( l_dt.locale (), l_dt.id () );
+
             return Node::obtain ( l_dt.locale (), l_dt.id () );
         }
 
-        Node* Node::obtain ( const QString& p_lcl, const QString& p_id ) {
+        Node* Node::obtain ( const QString& p_lcl, const QString& p_id, Arena* p_arn ) {
             Lexical::Data l_dt( p_id , p_lcl );
 
             if ( exists ( p_lcl , p_id ) ) {
-                Data::NodeInterface* l_ndInt = new Data::NodeInterface;
-                QDBusPendingReply<QString> l_reply = l_ndInt->read(l_dt);
+                Data::NodeInterface l_ndInt;
+                StageTimer l_tmr ( Metrics::NodeRead );
+                QDBusPendingReply<QString> l_reply = l_ndInt.read(l_dt);
                 l_reply.waitForFinished();
-                return new Node ( Lexical::Data::fromString(l_reply) );
+                return Node::form ( Lexical::Data::fromString(l_reply), p_arn );
             }
 
             return NULL;
         }
 
-        Node* Node::buildPseudo ( const QString& p_lcl, const QString& p_sym ) {
-            qDebug() << "(ling) [Node] Building pseudo-node for" << p_sym << "...";
+        Node* Node::buildPseudo ( const QString& p_lcl, const QString& p_sym, Arena* p_arn ) {
+            lingDebug ( "Node" ) << "Building pseudo-node for" << p_sym << "...";
             Lexical::Data l_dt("" , p_lcl , p_sym);
-            Data::NodeInterface* l_ndInt = new Data::NodeInterface;
-            QDBusPendingReply<QString> l_reply = l_ndInt->pseudo(l_dt);
+            Data::NodeInterface l_ndInt;
+            QDBusPendingReply<QString> l_reply;
+            {
+                StageTimer l_tmr ( Metrics::NodePseudo );
+                l_reply = l_ndInt.pseudo(l_dt);
+                l_reply.waitForFinished();
+            }
             l_dt = Lexical::Data::fromString((QString) l_reply);
-            return new Node ( l_dt );
+            return Node::form ( l_dt, p_arn );
+        }
+
+        NodeList Node::obtainAll ( const QList<QPair<QString, QString> >& p_keys, Arena* p_arn ) {
+            typedef QPair<QString, QString> NodeKey;
+            StageTimer l_tmr ( Metrics::NodeBatch );
+            Data::System::registerDataTypes();
+            Data::NodeInterface l_ndInt;
+            QList<QDBusPendingReply<bool> > l_exsts;
+            QList<QDBusPendingReply<QString> > l_rds;
+            NodeList l_nds;
+
+            // Send every call before waiting on any of them, so their round trips overlap.
+            foreach ( const NodeKey& l_key, p_keys )
+                l_exsts << l_ndInt.exists ( Lexical::Data ( l_key.second, l_key.first ) );
+
+            for ( int l_i = 0; l_i < p_keys.size (); l_i++ ) {
+                QDBusPendingReply<bool>& l_reply = l_exsts[l_i];
+                l_reply.waitForFinished ();
+
+                if ( !l_reply.isValid () || l_reply.isError () || !l_reply.value () )
+                    l_rds << QDBusPendingReply<QString> ();
+                else
+                    l_rds << l_ndInt.read ( Lexical::Data ( p_keys.at ( l_i ).second, p_keys.at ( l_i ).first ) );
+            }
+
+            l_nds.reserve ( p_keys.size () );
+            for ( int l_i = 0; l_i < p_keys.size (); l_i++ ) {
+                QDBusPendingReply<QString>& l_reply = l_rds[l_i];
+                l_reply.waitForFinished ();
+
+                if ( !l_reply.isValid () || l_reply.isError () )
+                    l_nds << NULL;
+                else
+                    l_nds << Node::form ( Lexical::Data::fromString ( l_reply ), p_arn );
+            }
+
+            return l_nds;
         }
 
         const bool Node::exists ( const QString& p_lcl, const QString& p_id ) {
             Data::System::registerDataTypes();
             Lexical::Data l_dt(p_id,p_lcl);
-            Data::NodeInterface* l_ndInt = new Data::NodeInterface;
-            QDBusPendingReply<bool> l_reply = l_ndInt->exists(l_dt);
-            l_reply.waitForFinished();
+            Data::NodeInterface l_ndInt;
+            QDBusPendingReply<bool> l_reply;
+            {
+                StageTimer l_tmr ( Metrics::NodeExists );
+                l_reply = l_ndInt.exists(l_dt);
+                l_reply.waitForFinished();
+            }
 
             if (!l_reply.isValid() || l_reply.isError()){
-                qDebug() << l_reply.error();
+                lingWarning ( "Node" ) << l_reply.error();
                 return false;
             } else return l_reply.value();
         }
 
-        Node* Node::form ( const Lexical::Data l_dt ) {
+        Node* Node::form ( const Lexical::Data l_dt, Arena* p_arn ) {
+            if ( p_arn )
+                return p_arn->create<Node> ( l_dt );
+
             return new Node ( l_dt );
         }
 
-        NodeList Node::expand ( const Node* p_nd ) {
-            NodeList l_vtr;
-            QVariantMap l_map;
-            int l_indx = 0;
+        NodeList Node::expand ( const Node* p_nd, const bool& p_shrd, Arena* p_arn ) {
+            if ( !p_shrd || p_nd->isPseudo () )
+                return formVariants ( p_nd, p_arn );
+
+            const ExpansionKey l_key ( p_nd->localeAtom (), p_nd->id () );
+
+            {
+                QReadLocker l_lck ( &s_expnsnLck );
+                const ExpansionCache::ConstIterator l_itr = s_expnsns.constFind ( l_key );
+                if ( l_itr != s_expnsns.constEnd () )
+                    return l_itr.value ();
+            }
 
-            l_map = p_nd->flags ();
+            const NodeList l_vtr = formVariants ( p_nd, NULL );
+            QWriteLocker l_lck ( &s_expnsnLck );
+            const ExpansionCache::ConstIterator l_itr = s_expnsns.constFind ( l_key );
 
-            for ( QVariantMap::iterator itr = l_map.begin (); itr != l_map.end (); l_indx++, itr++ ){
+            if ( l_itr != s_expnsns.constEnd () ) {
+                qDeleteAll ( l_vtr );
+                return l_itr.value ();
+            }
+
+            s_expnsns.insert ( l_key, l_vtr );
+            return l_vtr;
+        }
+
+        NodeList Node::formVariants ( const Node* p_nd, Arena* p_arn ) {
+            NodeList l_vtr;
+            const QVariantMap l_map = p_nd->flags ();
+
+            for ( QVariantMap::ConstIterator itr = l_map.constBegin (); itr != l_map.constEnd (); itr++ ){
                 QVariantMap l_mp;
                 l_mp.insert (itr.key (),itr.value ());
                 Lexical::Data l_dt(p_nd->id (),p_nd->locale (), p_nd->symbol ());
                 l_dt.setFlags (l_mp);
-                l_vtr.push_back ( const_cast<Node*>(Node::form(l_dt)) );
+                l_vtr.push_back ( Node::form(l_dt, p_arn) );
             }
 
-            qDebug() << "(ling) [Node] Expanded symbol" << p_nd->symbol () << "to spread across its" << l_map.size() << "variations.";
-
             return l_vtr;
         }
 
-        /// @todo Create a serialized version of the Link.
+        void Node::dropExpansion ( const QString& p_lcl, const QString& p_id ) {
+            // A locale that was never interned has nothing expanded under it.
+            Atom l_lcl = 0;
+            const bool l_knwn = Atoms::lookup ( p_lcl, l_lcl );
+            const ExpansionKey l_key ( l_lcl, p_id );
+            QWriteLocker l_lck ( &s_expnsnLck );
+            const ExpansionCache::Iterator l_itr = l_knwn ? s_expnsns.find ( l_key ) : s_expnsns.end ();
+
+            QList<NodeList> l_vtrs;
+            if ( l_itr != s_expnsns.end () ) {
+                l_vtrs << l_itr.value ();
+                s_expnsns.erase ( l_itr );
+            }
+
+            retireExpansions ( l_vtrs );
+        }
+
+        void Node::clearExpansions ( ) {
+            QWriteLocker l_lck ( &s_expnsnLck );
+            const QList<NodeList> l_vtrs = s_expnsns.values ();
+            s_expnsns.clear ();
+            retireExpansions ( l_vtrs );
+        }
+
+        const int Node::pinExpansions ( ) {
+            // Reading a revision older than the one about to be retired only keeps more alive.
+            QMutexLocker l_lck ( &s_pnLck );
+            const int l_rvsn = s_rvsn;
+            s_pnd[l_rvsn]++;
+            return l_rvsn;
+        }
+
+        void Node::unpinExpansions ( const int& p_rvsn ) {
+            bool l_oldst;
+            {
+                QMutexLocker l_lck ( &s_pnLck );
+                const QMap<int, int>::Iterator l_itr = s_pnd.find ( p_rvsn );
+                Q_ASSERT ( l_itr != s_pnd.end () );
+                l_oldst = l_itr == s_pnd.begin ();
+
+                if ( --l_itr.value () == 0 )
+                    s_pnd.erase ( l_itr );
+            }
+
+            // Only the oldest pin holds anything back.
+            if ( !l_oldst )
+                return;
+
+            QWriteLocker l_lck ( &s_expnsnLck );
+            reclaimExpansions ();
+        }
+
+        const int Node::revision ( ) {
+            return s_rvsn;
+        }
+
+        // A NodeCode has to stay small enough for a whole sentence of them to sit in cache.
+        typedef char NodeCodeFitsInAWord[sizeof ( NodeCode ) <= 8 ? 1 : -1];
+
+        const NodeCode NodeCode::form ( const int& p_wrd, const int& p_vrnt ) {
+            Q_ASSERT ( p_wrd >= 0 && p_vrnt >= 0 );
+            NodeCode l_cd;
+            l_cd.m_wrd = p_wrd;
+            l_cd.m_vrnt = p_vrnt;
+            return l_cd;
+        }
+
         const QString Link::toString() const {
-            return QString::null;
+            if ( !m_src || !m_dst )
+                return QString::null;
+
+            const QString l_lcl = locale ();
+            return l_lcl + "," + m_src->id () + ":" + l_lcl + "," + m_dst->id () + ":" + flags ();
         }
 
-        Link* Link::form ( const Node * p_src, const Node * p_dst, const QString & p_flgs, const QString & p_lcl ) {
+        Link* Link::form ( const Node * p_src, const Node * p_dst, const QString & p_flgs, const QString & p_lcl, Arena* p_arn ) {
+            if ( p_arn )
+                return p_arn->create<Link> ( p_src , p_dst , p_flgs , p_lcl );
+
+            return new Link ( p_src , p_dst , p_flgs , p_lcl );
+        }
+
+        Link* Link::form ( const Node * p_src, const Node * p_dst, const QString & p_flgs, const Atom & p_lcl, Arena* p_arn ) {
+            if ( p_arn )
+                return p_arn->create<Link> ( p_src , p_dst , p_flgs , p_lcl );
+
             return new Link ( p_src , p_dst , p_flgs , p_lcl );
         }
 
         Link* Link::fromString ( const QString& p_data ) {
-            char_separator<char> l_frstLvl ( ":" );
-            char_separator<char> l_scndLvl ( "," );
-
-            typedef tokenizer<char_separator<char> > Tokenizer;
-            Tokenizer toks ( p_data.toStdString() ,l_frstLvl );
-
-            Tokenizer::const_iterator itr = toks.begin();
-            const std::string node1 = *itr,
-                              node2 = * ( itr++ );
-
-            Tokenizer toks2 ( node1,l_scndLvl );
-            Tokenizer toks3 ( node2,l_scndLvl );
-            
-            const QString node1_id = QString::fromStdString(* ( ++ ( toks2.begin() ) )),
-                          node2_id = QString::fromStdString(* ( ++ ( toks3.begin() ) )),
-                          flags    = QString::fromStdString(* ( itr++ )),
-                          lcl      = QString::fromStdString(node1);
-
-            return new Link ( Node::obtain ( lcl ,node1_id ), Node::obtain ( lcl,node2_id ),
-                              flags, lcl );
+            LinkList l_lnks = Link::fromStrings ( p_data );
+            if ( l_lnks.isEmpty () )
+                return NULL;
+
+            // Only the first Link is handed back; the others, and the Node objects only they use, were formed on the heap for nothing.
+            Link* l_lnk = l_lnks.takeFirst ();
+            QSet<const Node*> l_nds;
+
+            foreach ( const Link* l_othr, l_lnks ) {
+                l_nds << l_othr->source () << l_othr->destination ();
+                delete l_othr;
+            }
+
+            l_nds.remove ( l_lnk->source () );
+            l_nds.remove ( l_lnk->destination () );
+            foreach ( const Node* l_nd, l_nds )
+                delete l_nd;
+
+            return l_lnk;
+        }
+
+        LinkList Link::fromStrings ( const QString& p_buf, Arena* p_arn ) {
+            typedef QPair<QString, QString> NodeKey;
+
+            QList<NodeKey> l_keys;
+            QHash<NodeKey, int> l_keyIdx;
+            QVector<LinkFields> l_flds;
+            const QChar* l_dt = p_buf.constData ();
+            const int l_sz = p_buf.size ();
+
+            // Each line reads "locale,source ID:locale,destination ID:flags".
+            for ( int l_bgn = 0; l_bgn < l_sz; ) {
+                int l_end = p_buf.indexOf ( QLatin1Char ( '\n' ), l_bgn );
+                if ( l_end < 0 )
+                    l_end = l_sz;
+
+                int l_sps[4] = { -1, -1, -1, -1 };
+                const QChar l_spChrs[4] = { QLatin1Char ( ',' ), QLatin1Char ( ':' ), QLatin1Char ( ',' ), QLatin1Char ( ':' ) };
+                for ( int l_i = l_bgn, l_j = 0; l_i < l_end && l_j < 4; l_i++ ) {
+                    if ( l_dt[l_i] == l_spChrs[l_j] )
+                        l_sps[l_j++] = l_i;
+                }
+
+                if ( l_sps[3] >= 0 ) {
+                    const NodeKey l_ends[2] = {
+                        NodeKey ( QString ( l_dt + l_bgn, l_sps[0] - l_bgn ), QString ( l_dt + l_sps[0] + 1, l_sps[1] - l_sps[0] - 1 ) ),
+                        NodeKey ( QString ( l_dt + l_sps[1] + 1, l_sps[2] - l_sps[1] - 1 ), QString ( l_dt + l_sps[2] + 1, l_sps[3] - l_sps[2] - 1 ) )
+                    };
+
+                    LinkFields l_fld;
+                    int* l_ndIdxs[2] = { &l_fld.m_src, &l_fld.m_dst };
+                    for ( int l_j = 0; l_j < 2; l_j++ ) {
+                        QHash<NodeKey, int>::ConstIterator l_itr = l_keyIdx.constFind ( l_ends[l_j] );
+                        if ( l_itr == l_keyIdx.constEnd () ) {
+                            l_itr = l_keyIdx.insert ( l_ends[l_j], l_keys.size () );
+                            l_keys << l_ends[l_j];
+                        }
+
+                        *l_ndIdxs[l_j] = l_itr.value ();
+                    }
+
+                    l_fld.m_flgs = QString ( l_dt + l_sps[3] + 1, l_end - l_sps[3] - 1 );
+                    l_flds << l_fld;
+                } else if ( l_end > l_bgn )
+                    lingWarning ( "Link" ) << "Skipped a malformed link:" << p_buf.mid ( l_bgn, l_end - l_bgn );
+
+                l_bgn = l_end + 1;
+            }
+
+            const NodeList l_nds = Node::obtainAll ( l_keys, p_arn );
+            QVector<bool> l_usd ( l_nds.size (), false );
+            LinkList l_lnks;
+            l_lnks.reserve ( l_flds.size () );
+
+            foreach ( const LinkFields& l_fld, l_flds ) {
+                const Node* l_src = l_nds.at ( l_fld.m_src ), *l_dst = l_nds.at ( l_fld.m_dst );
+                if ( l_src && l_dst ) {
+                    l_lnks << Link::form ( l_src, l_dst, l_fld.m_flgs, l_src->localeAtom (), p_arn );
+                    l_usd[l_fld.m_src] = l_usd[l_fld.m_dst] = true;
+                }
+            }
+
+            // Without an Arena, nothing would ever free a Node whose partner doesn't exist.
+            if ( !p_arn ) {
+                for ( int l_i = 0; l_i < l_nds.size (); l_i++ ) {
+                    if ( !l_usd.at ( l_i ) )
+                        delete l_nds.at ( l_i );
+                }
+            }
+
+            return l_lnks;
         }
 
         QDebug operator<<(QDebug dbg, const Node* p_nd) {
@@ -24,8 +24,11 @@
 
 #include <QMap>
 #include <QList>
+#include <QPair>
+#include <QVector>
 #include <QVariantMap>
 #include <data/wntrdata.hpp>
+#include "atoms.hpp"
 
 using namespace Wintermute::Data::Linguistics;
 
@@ -36,6 +39,8 @@ namespace Wintermute {
         struct Link;
         struct Node;
         struct Binding;
+        struct NodeCode;
+        class Arena;
 
         /**
          * @brief Represents a @c QVector of strings.
@@ -55,6 +60,12 @@ namespace Wintermute {
          */
         typedef QList<Link*> LinkList;
 
+        /**
+         * @brief Represents a @c QVector of @c NodeCodes;
+         * @typedef NodeCodeList
+         */
+        typedef QVector<NodeCode> NodeCodeList;
+
         /**
          * @brief An object representing the lexical and syntactic bindings of a word-symbol.
          *
@@ -94,13 +105,19 @@ namespace Wintermute {
             Q_PROPERTY(const QString symbol READ symbol)
             Q_PROPERTY(const QString value READ toString)
             Q_PROPERTY(const QVariantMap flags READ flags)
-            Q_PROPERTY(const Data* data READ data)
+            Q_PROPERTY(const Lexical::Data data READ data)
             Q_ENUMS(FormatVerbosity)
 
             friend class Link;
 
             protected:
-                Lexical::Data m_lxdt;
+                QString m_id;
+                Atom m_lclAtm;
+                QString m_sym;
+                QVariantMap m_flgs;
+
+            private:
+                static NodeList formVariants ( const Node*, Arena* );
 
             public:
                 /**
@@ -121,25 +138,23 @@ namespace Wintermute {
                  * @brief Null constructor.
                  * @fn Node
                  */
-                Node( ) : m_lxdt() { }
+                Node( ) : m_id(), m_lclAtm(0), m_sym(), m_flgs() { }
 
                 /**
                  * @brief Default constructor.
                  * @fn Node
                  * @param p_lxdt The Lexical::Data representing the internal data of the Node.
                  */
-                explicit Node ( Lexical::Data p_lxdt ) : m_lxdt(p_lxdt) {
-                    this->setProperty ("OriginalToken",symbol ());
-                }
+                explicit Node ( Lexical::Data p_lxdt ) : m_id(p_lxdt.id ()),
+                    m_lclAtm(Atoms::intern (p_lxdt.locale ())), m_sym(p_lxdt.symbol ()), m_flgs(p_lxdt.flags ()) { }
 
                 /**
                  * @brief Copy constructor.
                  * @fn Node
                  * @param p_nd The node being copied.
                  */
-                Node( const Node& p_nd ) : m_lxdt(p_nd.m_lxdt) {
-                    this->setProperty ("OriginalToken",symbol ());
-                }
+                Node( const Node& p_nd ) : m_id(p_nd.m_id), m_lclAtm(p_nd.m_lclAtm),
+                    m_sym(p_nd.m_sym), m_flgs(p_nd.m_flgs) { }
 
                 /**
                  * @brief Deconstructor.
@@ -157,7 +172,7 @@ namespace Wintermute {
                  * @see Lexical::Data
                  */
                 Q_INVOKABLE inline const QString id() const {
-                    return m_lxdt.id ();
+                    return m_id;
                 }
 
                 /**
@@ -170,7 +185,15 @@ namespace Wintermute {
                  * @see Lexical::Data
                  */
                 Q_INVOKABLE inline const QString locale() const {
-                    return m_lxdt.locale ();
+                    return Atoms::toString (m_lclAtm);
+                }
+
+                /**
+                 * @brief Obtains the interned locale of the Node.
+                 * @fn localeAtom
+                 */
+                inline const Atom localeAtom() const {
+                    return m_lclAtm;
                 }
 
                 /**
@@ -179,7 +202,7 @@ namespace Wintermute {
                  * @return The symbol of the Node, or an empty QString.
                  */
                 Q_INVOKABLE inline const QString symbol() const {
-                    return m_lxdt.symbol ();
+                    return m_sym;
                 }
 
                 /**
@@ -188,16 +211,17 @@ namespace Wintermute {
                  * @return The flags of the Node.
                  */
                 Q_INVOKABLE inline const QVariantMap flags() const {
-                    return m_lxdt.flags ();
+                    return m_flgs;
                 }
 
                 /**
                  * @brief Obtains the internal Lexical::Data object.
                  * @fn data
                  * @return The Lexical::Data defining this node.
+                 * @note The Node keeps its ID and locale as atoms, so the Lexical::Data is rebuilt on each call.
                  */
-                Q_INVOKABLE inline const Lexical::Data* data() const {
-                    return &m_lxdt;
+                Q_INVOKABLE inline const Lexical::Data data() const {
+                    return Lexical::Data ( id (), locale (), m_sym, m_flgs );
                 }
 
                 /**
@@ -224,7 +248,7 @@ namespace Wintermute {
                  * @return 'true' if the flags and ID are pseudo-worthy, returns 'false' otherwise.
                  */
                 Q_INVOKABLE inline const bool isPseudo() const {
-                    return Lexical::Cache::isPseudo (m_lxdt);
+                    return Lexical::Cache::isPseudo (data ());
                 }
 
                 /**
@@ -263,9 +287,24 @@ namespace Wintermute {
                  * @fn obtain
                  * @param p_lcl The locale of the potential Node.
                  * @param p_sym The symbol of the potential Node.
+                 * @param p_arn The Arena to create the Node in, or NULL to create it on the heap.
                  * @return A Node if the Node exists, or NULL if it doesn't.
                  */
-                static Node* obtain ( const QString&, const QString& );
+                static Node* obtain ( const QString&, const QString&, Arena* = NULL );
+
+                /**
+                 * @brief Obtains many Node objects at once.
+                 *
+                 * Rather than waiting on two calls to the data service for each Node, as
+                 * obtain() does, every existence check is sent before any answer is waited
+                 * on, and then every read; the whole lot costs about two round trips.
+                 *
+                 * @fn obtainAll
+                 * @param p_keys The locale and ID of each Node.
+                 * @param p_arn The Arena to create the Node objects in, or NULL to create them on the heap.
+                 * @return A Node for each key, in the same order, or NULL where one doesn't exist.
+                 */
+                static NodeList obtainAll ( const QList<QPair<QString, QString> >&, Arena* = NULL );
 
                 /**
                  * @brief Creates a new Node based on a Lexical::Data.
@@ -292,19 +331,21 @@ namespace Wintermute {
                  * @fn buildPseudo
                  * @param p_lcl The locale to use.
                  * @param p_sym The symbol of the Node.
+                 * @param p_arn The Arena to create the Node in, or NULL to create it on the heap.
                  * @return A Node representing the pseudo-Node, or NULL if no pseudo-Nodes could be formed.
                  * @todo Check if this Node exists. If it does, return that instead of forming a pseudo-Node.
                  */
-                static Node* buildPseudo ( const QString&, const QString& );
+                static Node* buildPseudo ( const QString&, const QString&, Arena* = NULL );
 
                 /**
                  * @brief Creates a Node based on a specific Lexical::Data.
                  * @fn form
                  * @param p_lxdt The Lexical::Data representing the internal data of the Node.
+                 * @param p_arn The Arena to create the Node in, or NULL to create it on the heap.
                  * @return A new Node with @var p_lxdt at its core.
                  * @see Node(Lexical::Data p_lxdt)
                  */
-                static Node* form ( Lexical::Data );
+                static Node* form ( Lexical::Data, Arena* = NULL );
 
                 /**
                  * @brief Splits a Node into many Nodes.
@@ -314,11 +355,71 @@ namespace Wintermute {
                  * Nodes in a NodeList that each have only one of the flags defined in
                  * their originating Node.
                  *
+                 * The variants of each (locale, ID) are formed once and then shared by
+                 * every sentence and thread that expands that Node; they're owned by the
+                 * cache and must not be modified or deleted. Pseudo-Nodes are never shared.
+                 * Shared variants stay valid only between pinExpansions() and unpinExpansions().
+                 *
                  * @fn expand
                  * @param p_node The Node to split.
+                 * @param p_shrd Whether to use the shared variants; when 'false', a new set owned by the caller is formed.
+                 * @param p_arn The Arena to create unshared variants in, or NULL to create them on the heap.
                  * @return A NodeList with a Node for each flag defind in p_node.
                  */
-                static NodeList expand ( const Node* );
+                static NodeList expand ( const Node*, const bool& = true, Arena* = NULL );
+
+                /**
+                 * @brief Drops the shared variants of one (locale, ID); create() calls it for what it writes.
+                 *
+                 * The variants are deleted once no parse pinned before the drop remains.
+                 *
+                 * @fn dropExpansion
+                 * @param p_lcl The locale of the Node.
+                 * @param p_id The ID of the Node.
+                 */
+                static void dropExpansion ( const QString&, const QString& );
+
+                /**
+                 * @brief Drops every shared variant formed by expand().
+                 *
+                 * This has to be called when the lexicon is changed by anyone else. The
+                 * variants are deleted once no parse pinned before the drop remains.
+                 *
+                 * @fn clearExpansions
+                 */
+                static void clearExpansions ( );
+
+                /**
+                 * @brief Keeps the shared variants handed out by expand() from being deleted.
+                 *
+                 * Every parse pins them for its whole length. Variants dropped at some
+                 * revision are deleted once every parse pinned before that revision has
+                 * undone its pin, so a busy service still frees them.
+                 *
+                 * @fn pinExpansions
+                 * @return The revision pinned at; hand it to unpinExpansions().
+                 * @see unpinExpansions
+                 */
+                static const int pinExpansions ( );
+
+                /**
+                 * @brief Undoes pinExpansions().
+                 * @fn unpinExpansions
+                 * @param p_rvsn The revision returned by pinExpansions().
+                 */
+                static void unpinExpansions ( const int& );
+
+                /**
+                 * @brief Obtains the revision of the lexicon, as far as this process knows.
+                 *
+                 * It changes whenever create() writes a Node or clearExpansions() or dropExpansion() is
+                 * called; anything derived from the lexicon can be stamped with it to
+                 * tell when it's gone stale.
+                 *
+                 * @fn revision
+                 * @see ResultCache
+                 */
+                static const int revision ( );
 
                 /**
                  * @brief Equality operator.
@@ -327,12 +428,37 @@ namespace Wintermute {
                  * @return bool
                  */
                 bool operator== (const Node& p_nd) {
-                    return this->id () == p_nd.id () &&
-                           this->m_lxdt.locale () == this->m_lxdt.locale ();
+                    return this->m_id == p_nd.m_id &&
+                           this->m_lclAtm == p_nd.m_lclAtm;
                 }
 
         };
 
+        /**
+         * @brief A compact, plain-value stand-in for a Node during parsing.
+         *
+         * Expanding a sentence can form a great deal of paths, each holding a variant
+         * of every word. Rather than carrying QObject-based Node objects around while
+         * those paths are enumerated, the Parser works with NodeCode objects: which
+         * variant of which word a path holds. A NodeCode is copied by value and compared
+         * by integers; the Node it stands for is only looked up (by the word and variant
+         * indices) once a path is handed to Meaning::form().
+         *
+         * @struct NodeCode syntax.hpp "src/syntax.hpp"
+         */
+        struct NodeCode {
+            quint32 m_wrd;  /**< The index of the word in the sentence. */
+            quint32 m_vrnt; /**< The index of the variant within that word's expansion. */
+
+            /**
+             * @brief Forms the NodeCode of a variant.
+             * @fn form
+             * @param p_wrd The index of the word in the sentence.
+             * @param p_vrnt The index of the variant within that word's expansion.
+             */
+            static const NodeCode form ( const int&, const int& );
+        };
+
         /**
          * @brief Represents the syntactical binding of two Node objects by a pre-defined relationship.
          *
@@ -354,6 +480,7 @@ namespace Wintermute {
          */
         class Link : public QObject {
             friend class Meaning;
+            friend class Arena;
             Q_OBJECT
             Q_PROPERTY(const Node* Source READ source)
             Q_PROPERTY(const Node* Destination READ destination)
@@ -381,17 +508,46 @@ namespace Wintermute {
                  * @param p_node2 The destination Node.
                  * @param p_flag The flags defining the relationship between the source Node and the destination Node.
                  * @param p_lcl The locale of the link.
+                 * @param p_arn The Arena to create the Link in, or NULL to create it on the heap.
                  * @warning The locale property may become obsolete in order to ensure that we're able to support translations.
                  */
-                static Link* form ( const Node* , const Node* , const QString&, const QString& );
+                static Link* form ( const Node* , const Node* , const QString&, const QString&, Arena* = NULL );
+
+                /**
+                 * @brief Generates a Link from two Nodes, binding flags and an interned locale.
+                 * @fn form
+                 * @param p_node1 The source Node.
+                 * @param p_node2 The destination Node.
+                 * @param p_flag The flags defining the relationship between the two Nodes.
+                 * @param p_lcl The interned locale of the link.
+                 * @param p_arn The Arena to create the Link in, or NULL to create it on the heap.
+                 */
+                static Link* form ( const Node* , const Node* , const QString&, const Atom&, Arena* = NULL );
 
                 /**
                  * @brief Forms a link from a QString.
                  * @fn fromString
-                 * @param p_str The QString representing a Link.
+                 * @param p_str The QString representing a Link, as formed by toString().
+                 * @return The first Link read, or NULL if none is well-formed with both its Node objects existing.
+                 *         Any other Link read, and the Node objects only it used, are deleted.
+                 * @see fromStrings
                  */
                 static Link* fromString ( const QString& );
 
+                /**
+                 * @brief Forms many Link objects from their string forms in one go.
+                 *
+                 * The buffer is read in one pass, without copying each Link's fields out,
+                 * and the Node objects named are looked up together with Node::obtainAll(),
+                 * each distinct one only once.
+                 *
+                 * @fn fromStrings
+                 * @param p_buf The string forms of the Link objects, one per line.
+                 * @param p_arn The Arena to create the Link and Node objects in, or NULL to create them on the heap.
+                 * @return The Link objects, in order; malformed lines and Link objects whose Node objects don't exist are left out.
+                 */
+                static LinkList fromStrings ( const QString&, Arena* = NULL );
+
                 /**
                  * @brief Obtains the source Node.
                  * @fn source
@@ -421,7 +577,13 @@ namespace Wintermute {
                  * @deprecated This method, as long with the concept of locale for Links, are phasing out.
                  * @obsolete
                  */
-                Q_INVOKABLE inline const QString locale() const { return m_lcl; }
+                Q_INVOKABLE inline const QString locale() const { return Atoms::toString ( m_lcl ); }
+
+                /**
+                 * @brief Obtains the interned locale of the Link.
+                 * @fn localeAtom
+                 */
+                inline const Atom localeAtom() const { return m_lcl; }
 
                 /**
                  * @brief Obtains the flags of the Link.
@@ -432,6 +594,11 @@ namespace Wintermute {
 
                 /**
                  * @brief Obtains a QString that represents this Link.
+                 *
+                 * The QString reads "locale,source ID:locale,destination ID:flags". For
+                 * storing or handing over whole Meaning objects, Meaning::toBinary() is
+                 * far more compact.
+                 *
                  * @fn toString
                  */
                 Q_INVOKABLE const QString toString() const;
@@ -440,14 +607,14 @@ namespace Wintermute {
                  * @brief Null constructor.
                  * @fn Link
                  */
-                Link() : m_lcl(""), m_flgs(""), m_src(NULL), m_dst(NULL), m_lvl(0) { }
+                Link() : m_lvl(0), m_src(NULL), m_dst(NULL), m_flgs(), m_lcl(0) { }
 
                 /**
                  * @brief Copy constructor.
                  * @fn Link
                  * @param p_lnk The Link to be copied.
                  */
-                Link( const Link& p_lnk ) : m_src(p_lnk.m_src), m_dst(p_lnk.m_dst), m_flgs(p_lnk.m_flgs), m_lcl(p_lnk.m_lcl), m_lvl(0) { }
+                Link( const Link& p_lnk ) : m_lvl(0), m_src(p_lnk.m_src), m_dst(p_lnk.m_dst), m_flgs(p_lnk.m_flgs), m_lcl(p_lnk.m_lcl) { }
 
             protected:
                 /**
@@ -459,14 +626,25 @@ namespace Wintermute {
                  * @param p_lcl The locale of the flag.
                  */
                 Link ( const Node* p_src, const Node* p_dst, const QString& p_flgs, const QString& p_lcl ) :
-                        m_src ( p_src ),m_dst ( p_dst ), m_flgs ( p_flgs ), m_lcl ( p_lcl ), m_lvl(0) { }
+                        m_lvl(0), m_src ( p_src ),m_dst ( p_dst ), m_flgs ( p_flgs ), m_lcl ( Atoms::intern ( p_lcl ) ) { }
+
+                /**
+                 * @brief Initialization constructor, from an interned locale.
+                 * @fn Link
+                 * @param p_src The source Node.
+                 * @param p_dst The destination Node.
+                 * @param p_flgs The relationship described by the flags of the source Node's locale.
+                 * @param p_lcl The interned locale of the flag.
+                 */
+                Link ( const Node* p_src, const Node* p_dst, const QString& p_flgs, const Atom& p_lcl ) :
+                        m_lvl(0), m_src ( p_src ),m_dst ( p_dst ), m_flgs ( p_flgs ), m_lcl ( p_lcl ) { }
 
             private:
                 mutable int m_lvl;
                 const Node* m_src;
                 const Node* m_dst;
                 const QString m_flgs;
-                const QString m_lcl;
+                const Atom m_lcl;
         };
 
         /**
@@ -490,6 +668,8 @@ namespace Wintermute {
 Q_DECLARE_METATYPE(Wintermute::Linguistics::Link)
 Q_DECLARE_METATYPE(Wintermute::Linguistics::Node)
 
+Q_DECLARE_TYPEINFO(Wintermute::Linguistics::NodeCode, Q_PRIMITIVE_TYPE);
+
 #endif	/* __SYNTAX_HPP */
 
 // kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,274 @@
+/**
+ * @file    tokens.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 6:05 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "tokens.hpp"
+
+namespace Wintermute {
+    namespace Linguistics {
+        namespace {
+            enum CharacterClass {
+                Symbol = 0, /**< Anything that's neither whitespace nor alphanumeric. */
+                Word,       /**< A letter or a number. */
+                Space       /**< Whitespace. */
+            };
+
+            /// Classifies every ASCII character up-front.
+            struct AsciiTable {
+                unsigned char m_cls[128];
+
+                AsciiTable() {
+                    for ( int l_c = 0; l_c < 128; l_c++ ) {
+                        if ( ( l_c >= '0' && l_c <= '9' ) || ( l_c >= 'a' && l_c <= 'z' ) || ( l_c >= 'A' && l_c <= 'Z' ) )
+                            m_cls[l_c] = Word;
+                        else if ( l_c == ' ' || ( l_c >= '\t' && l_c <= '\r' ) )
+                            m_cls[l_c] = Space;
+                        else
+                            m_cls[l_c] = Symbol;
+                    }
+                }
+            };
+
+            const AsciiTable s_ascii;
+
+            /// Determines if a character ends a sentence.
+            inline bool isTerminator ( const QChar& p_chr ) {
+                const ushort l_uc = p_chr.unicode ();
+                return l_uc == '.' || l_uc == '!' || l_uc == '?' || l_uc == ';';
+            }
+
+            /// Determines if a character closes a quotation or a bracket.
+            inline bool isCloser ( const QChar& p_chr ) {
+                switch ( p_chr.unicode () ) {
+                    case '"': case '\'': case ')': case ']':
+                    case 0x00BB: case 0x2019: case 0x201D: case 0x203A:
+                        return true;
+
+                    default:
+                        return p_chr.category () == QChar::Punctuation_FinalQuote ||
+                               p_chr.category () == QChar::Punctuation_Close;
+                }
+            }
+
+            inline bool isLineBreak ( const QChar& p_chr ) {
+                const ushort l_uc = p_chr.unicode ();
+                return l_uc == '\n' || l_uc == '\r' || l_uc == 0x2028 || l_uc == 0x2029;
+            }
+
+            /// Determines if the word starting at an offset, once whitespace is skipped, begins with a capital letter.
+            bool startsCapitalized ( const QString& p_txt, int p_pos ) {
+                while ( p_pos < p_txt.length () && p_txt.at ( p_pos ).isSpace () )
+                    p_pos++;
+
+                return p_pos < p_txt.length () && p_txt.at ( p_pos ).isUpper ();
+            }
+
+            /// Determines if a digit comes next, once whitespace is skipped.
+            bool startsNumeric ( const QString& p_txt, int p_pos ) {
+                while ( p_pos < p_txt.length () && p_txt.at ( p_pos ).isSpace () )
+                    p_pos++;
+
+                return p_pos < p_txt.length () && p_txt.at ( p_pos ).isDigit ();
+            }
+
+            /// Records the characters between two offsets as the next sentence, less any surrounding whitespace.
+            void appendTrimmed ( const QString& p_txt, int p_pos, int p_stop, SentenceList& p_sntncs, int& p_cnt ) {
+                while ( p_pos < p_stop && p_txt.at ( p_pos ).isSpace () )
+                    p_pos++;
+
+                while ( p_stop > p_pos && p_txt.at ( p_stop - 1 ).isSpace () )
+                    p_stop--;
+
+                if ( p_stop > p_pos ) {
+                    const SentenceRange l_rng = { p_pos, p_stop - p_pos };
+                    if ( p_cnt == p_sntncs.size () )
+                        p_sntncs.resize ( qMax ( 8, p_sntncs.size () * 2 ) );
+
+                    p_sntncs[p_cnt++] = l_rng;
+                }
+            }
+
+            inline CharacterClass classify ( const QChar& p_chr ) {
+                const ushort l_uc = p_chr.unicode ();
+                if ( l_uc < 128 )
+                    return static_cast<CharacterClass> ( s_ascii.m_cls[l_uc] );
+
+                if ( p_chr.isSpace () )
+                    return Space;
+
+                return p_chr.isLetterOrNumber () ? Word : Symbol;
+            }
+        }
+
+        TokenStore::TokenStore() : m_buf(NULL), m_tkns(), m_cnt(0) { }
+
+        void TokenStore::clear() {
+            m_buf = NULL;
+            m_cnt = 0;
+        }
+
+        void TokenStore::tokenize ( const QString& p_buf, const int& p_pos, const int& p_len ) {
+            const QChar* l_chrs = p_buf.unicode ();
+            const int l_end = ( p_len < 0 ) ? p_buf.length () : qMin ( p_buf.length (), p_pos + p_len );
+            int l_i = p_pos;
+
+            clear ();
+            m_buf = &p_buf;
+
+            while ( l_i < l_end ) {
+                while ( l_i < l_end && classify ( l_chrs[l_i] ) == Space )
+                    l_i++;
+
+                if ( l_i == l_end )
+                    break;
+
+                const int l_strt = l_i;
+                while ( l_i < l_end && classify ( l_chrs[l_i] ) != Space )
+                    l_i++;
+
+                if ( m_cnt == m_tkns.size () )
+                    m_tkns.resize ( qMax ( 16, m_tkns.size () * 2 ) );
+
+                m_tkns[m_cnt++] = dissect ( p_buf, l_strt, l_i - l_strt );
+            }
+        }
+
+        const TokenRange TokenStore::dissect ( const QString& p_buf, const int& p_pos, const int& p_len ) {
+            const QChar* l_chrs = p_buf.unicode () + p_pos;
+            TokenRange l_rng = { p_pos, 0, 0, 0 };
+            int l_i = 0;
+
+            /// Prefix symbol
+            while ( l_i < p_len && classify ( l_chrs[l_i] ) != Word )
+                l_i++;
+
+            l_rng.m_prfx = l_i;
+
+            /// Root symbol
+            while ( l_i < p_len && classify ( l_chrs[l_i] ) == Word )
+                l_i++;
+
+            l_rng.m_root = l_i - l_rng.m_prfx;
+
+            /// Suffix symbol
+            l_rng.m_sffx = p_len - l_i;
+            return l_rng;
+        }
+
+        SentenceSegmenter::SentenceSegmenter ( const QStringList& p_abbrs ) : m_abbrs(p_abbrs) { }
+
+        const QStringList SentenceSegmenter::defaultAbbreviations() {
+            static const QStringList s_abbrs = QStringList() << "mr" << "mrs" << "ms" << "dr" << "prof"
+                                                             << "sr" << "jr" << "st" << "mt" << "vs"
+                                                             << "etc" << "e.g" << "i.e" << "cf"
+                                                             << "inc" << "ltd" << "approx";
+            return s_abbrs;
+        }
+
+        const bool SentenceSegmenter::isAbbreviation ( const QString& p_txt, const int& p_strt, const int& p_prd ) const {
+            int l_i = p_prd;
+            while ( l_i > p_strt && ( p_txt.at ( l_i - 1 ).isLetterOrNumber () || p_txt.at ( l_i - 1 ) == '.' ) )
+                l_i--;
+
+            const QStringRef l_wrd ( &p_txt, l_i, p_prd - l_i );
+            if ( l_wrd.isEmpty () )
+                return false;
+
+            // An initial, as in "J. Smith" or "John F. Kennedy": a capital letter before a capitalized
+            // name, itself leading the sentence or following a capitalized word. "a B. Then" still splits.
+            if ( l_wrd.length () == 1 ) {
+                if ( !l_wrd.at ( 0 ).isUpper () || !startsCapitalized ( p_txt, p_prd + 1 ) )
+                    return false;
+
+                int l_prv = l_i;
+                while ( l_prv > p_strt && p_txt.at ( l_prv - 1 ).isSpace () )
+                    l_prv--;
+
+                if ( l_prv == p_strt )
+                    return true;
+
+                while ( l_prv > p_strt && !p_txt.at ( l_prv - 1 ).isSpace () )
+                    l_prv--;
+
+                return p_txt.at ( l_prv ).isUpper ();
+            }
+
+            // "No. 5" is an abbreviation; "the answer is no." isn't.
+            if ( l_wrd.compare ( QLatin1String ( "no" ), Qt::CaseInsensitive ) == 0 )
+                return startsNumeric ( p_txt, p_prd + 1 );
+
+            foreach ( const QString& l_abbr, m_abbrs ) {
+                if ( l_wrd.compare ( l_abbr, Qt::CaseInsensitive ) == 0 )
+                    return true;
+            }
+
+            return false;
+        }
+
+        const int SentenceSegmenter::segment ( const QString& p_txt, SentenceList& p_sntncs ) const {
+            const int l_len = p_txt.length ();
+            int l_strt = 0, l_i = 0, l_cnt = 0;
+
+            while ( l_i < l_len ) {
+                const QChar l_chr = p_txt.at ( l_i );
+                int l_end = -1, l_nxt = l_i + 1;
+
+                if ( isLineBreak ( l_chr ) )
+                    l_end = l_i;
+                else if ( isTerminator ( l_chr ) ) {
+                    while ( l_nxt < l_len && ( isTerminator ( p_txt.at ( l_nxt ) ) || isCloser ( p_txt.at ( l_nxt ) ) ) )
+                        l_nxt++;
+
+                    if ( ( l_nxt == l_len || p_txt.at ( l_nxt ).isSpace () ) &&
+                         !( l_chr == '.' && l_nxt == l_i + 1 && isAbbreviation ( p_txt, l_strt, l_i ) ) )
+                        l_end = l_nxt;
+                }
+
+                if ( l_end != -1 ) {
+                    appendTrimmed ( p_txt, l_strt, l_end, p_sntncs, l_cnt );
+                    l_strt = ( l_end == l_i ) ? l_i + 1 : l_end;
+                }
+
+                l_i = l_nxt;
+            }
+
+            appendTrimmed ( p_txt, l_strt, l_len, p_sntncs, l_cnt );
+            return l_cnt;
+        }
+
+        const QStringRef TokenStore::prefix ( const int& p_indx ) const {
+            const TokenRange& l_rng = at ( p_indx );
+            return QStringRef ( m_buf, l_rng.m_pos, l_rng.m_prfx );
+        }
+
+        const QStringRef TokenStore::symbol ( const int& p_indx ) const {
+            const TokenRange& l_rng = at ( p_indx );
+            return QStringRef ( m_buf, l_rng.rootPosition (), l_rng.m_root );
+        }
+
+        const QStringRef TokenStore::suffix ( const int& p_indx ) const {
+            const TokenRange& l_rng = at ( p_indx );
+            return QStringRef ( m_buf, l_rng.suffixPosition (), l_rng.m_sffx );
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,233 @@
+/**
+ * @file    tokens.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 18, 2026 6:05 PM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __TOKENS_HPP__
+#define __TOKENS_HPP__
+
+#include <QString>
+#include <QVector>
+#include <QStringList>
+
+namespace Wintermute {
+    namespace Linguistics {
+        struct TokenRange;
+        struct SentenceRange;
+        class TokenStore;
+        class SentenceSegmenter;
+
+        /**
+         * @brief Represents a QVector of SentenceRange objects.
+         * @see SentenceSegmenter::segment()
+         * @typedef SentenceList
+         */
+        typedef QVector<SentenceRange> SentenceList;
+
+        /**
+         * @brief Represents the prefix, root and suffix of a token as offsets into its text.
+         *
+         * The prefix is the run of non-alphanumeric characters that leads the token, the
+         * root (or symbol) is the alphanumeric run that follows and the suffix is everything
+         * after it, up to the next whitespace.
+         *
+         * @struct TokenRange tokens.hpp "src/tokens.hpp"
+         */
+        struct TokenRange {
+            int m_pos;  /**< The offset of the token's first character in the text. */
+            int m_prfx; /**< The length of the prefix. */
+            int m_root; /**< The length of the root. */
+            int m_sffx; /**< The length of the suffix. */
+
+            /**
+             * @brief Obtains the offset of the root in the text.
+             * @fn rootPosition
+             */
+            inline const int rootPosition() const { return m_pos + m_prfx; }
+
+            /**
+             * @brief Obtains the offset of the suffix in the text.
+             * @fn suffixPosition
+             */
+            inline const int suffixPosition() const { return m_pos + m_prfx + m_root; }
+
+            /**
+             * @brief Obtains the length of the whole token.
+             * @fn length
+             */
+            inline const int length() const { return m_prfx + m_root + m_sffx; }
+        };
+
+        /**
+         * @brief A reusable store of TokenRange objects over a piece of text.
+         *
+         * A TokenStore splits text on whitespace and records each token as a TokenRange
+         * pointing into the original buffer; no characters are copied. Its storage only
+         * ever grows, so a store kept around between requests (as the Parser does)
+         * tokenizes without allocating once it has seen its largest input.
+         *
+         * Characters in the ASCII range are classified with a lookup table; anything
+         * else falls back onto QChar's Unicode properties.
+         *
+         * @class TokenStore tokens.hpp "src/tokens.hpp"
+         */
+        class TokenStore {
+            public:
+                /**
+                 * @brief Null constructor.
+                 * @fn TokenStore
+                 */
+                TokenStore();
+
+                /**
+                 * @brief Tokenizes a range of text, replacing the current contents of the store.
+                 * @fn tokenize
+                 * @param p_buf The text to tokenize; it must outlive the use of this store's contents.
+                 * @param p_pos The offset to start tokenizing at.
+                 * @param p_len The number of characters to tokenize, or -1 for the rest of the text.
+                 */
+                void tokenize ( const QString&, const int& = 0, const int& = -1 );
+
+                /**
+                 * @brief Empties the store, keeping its storage for reuse.
+                 * @fn clear
+                 */
+                void clear();
+
+                /**
+                 * @brief Obtains the number of tokens in the store.
+                 * @fn size
+                 */
+                inline const int size() const { return m_cnt; }
+
+                /**
+                 * @brief Determines if the store holds no tokens.
+                 * @fn isEmpty
+                 */
+                inline const bool isEmpty() const { return m_cnt == 0; }
+
+                /**
+                 * @brief Obtains the TokenRange at an index.
+                 * @fn at
+                 * @param p_indx The index of the token.
+                 */
+                inline const TokenRange& at ( const int& p_indx ) const { return m_tkns.at ( p_indx ); }
+
+                /**
+                 * @brief Obtains the prefix of a token, without copying it.
+                 * @fn prefix
+                 * @param p_indx The index of the token.
+                 */
+                const QStringRef prefix ( const int& ) const;
+
+                /**
+                 * @brief Obtains the root of a token, without copying it.
+                 * @fn symbol
+                 * @param p_indx The index of the token.
+                 */
+                const QStringRef symbol ( const int& ) const;
+
+                /**
+                 * @brief Obtains the suffix of a token, without copying it.
+                 * @fn suffix
+                 * @param p_indx The index of the token.
+                 */
+                const QStringRef suffix ( const int& ) const;
+
+                /**
+                 * @brief Splits one whitespace-free token into its prefix, root and suffix.
+                 * @fn dissect
+                 * @param p_buf The text holding the token.
+                 * @param p_pos The offset of the token in the text.
+                 * @param p_len The length of the token.
+                 */
+                static const TokenRange dissect ( const QString&, const int&, const int& );
+
+            private:
+                const QString* m_buf;
+                QVector<TokenRange> m_tkns;
+                int m_cnt;
+        };
+
+        /**
+         * @brief Represents a sentence as an offset and a length into its text.
+         * @struct SentenceRange tokens.hpp "src/tokens.hpp"
+         */
+        struct SentenceRange {
+            int m_pos; /**< The offset of the sentence's first character in the text. */
+            int m_len; /**< The length of the sentence, including its terminating punctuation. */
+        };
+
+        /**
+         * @brief Splits text into sentences in a single pass over its characters.
+         *
+         * A sentence ends at a line break, or at one of '.', '!', '?' or ';' once any
+         * closing quotes or brackets following it are consumed and whitespace (or the
+         * end of the text) comes next. A period doesn't end a sentence when it closes
+         * a known abbreviation (like "Dr."), "No." before a number, or an initial: a
+         * capital letter followed by a capitalized name, and leading the sentence or
+         * following a capitalized word ("J. Smith", "John F. Kennedy").
+         *
+         * The text is never copied; each sentence is reported as a SentenceRange that
+         * can be passed straight to TokenStore::tokenize().
+         *
+         * @class SentenceSegmenter tokens.hpp "src/tokens.hpp"
+         */
+        class SentenceSegmenter {
+            public:
+                /**
+                 * @brief Default constructor.
+                 * @fn SentenceSegmenter
+                 * @param p_abbrs The abbreviations (without their period) that don't end a sentence.
+                 */
+                explicit SentenceSegmenter ( const QStringList& = defaultAbbreviations() );
+
+                /**
+                 * @brief Splits text into sentences.
+                 *
+                 * The list is filled from its start and never shrinks, so its storage is
+                 * reused from one text to the next; entries past the count returned are
+                 * left over from earlier texts.
+                 *
+                 * @fn segment
+                 * @param p_txt The text to be split.
+                 * @param p_sntncs The list to be filled.
+                 * @return The number of sentences found.
+                 */
+                const int segment ( const QString&, SentenceList& ) const;
+
+                /**
+                 * @brief Obtains the abbreviations used when none are specified.
+                 * @fn defaultAbbreviations
+                 */
+                static const QStringList defaultAbbreviations();
+
+            private:
+                const bool isAbbreviation ( const QString&, const int&, const int& ) const;
+                QStringList m_abbrs;
+        };
+    }
+}
+
+Q_DECLARE_TYPEINFO(Wintermute::Linguistics::TokenRange, Q_PRIMITIVE_TYPE);
+Q_DECLARE_TYPEINFO(Wintermute::Linguistics::SentenceRange, Q_PRIMITIVE_TYPE);
+
+#endif /* __TOKENS_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -0,0 +1,186 @@
+/**
+ * @file    transport.cpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 19, 2026 5:10 AM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#include "transport.hpp"
+#include "logging.hpp"
+#include <climits>
+#include <cstring>
+#include <QCoreApplication>
+
+namespace Wintermute {
+    namespace Linguistics {
+        namespace {
+            const quint32 s_mgc = 0x574C5231;
+            const quint32 s_vrsn = 1;
+        }
+
+        ResultChannel::ResultChannel ( const int& p_lmt ) : m_sgmnts (), m_ownrs (), m_ordr (), m_clnts (), m_lmt ( qMax ( 1, p_lmt ) ), m_lck () { }
+
+        ResultChannel::~ResultChannel() {
+            qDeleteAll ( m_sgmnts );
+        }
+
+        const bool ResultChannel::isEnabledFor ( const QString& p_clnt ) const {
+            QMutexLocker l_lck ( &m_lck );
+            return m_clnts.contains ( p_clnt );
+        }
+
+        void ResultChannel::setEnabledFor ( const QString& p_clnt, const bool& p_enbl ) {
+            QMutexLocker l_lck ( &m_lck );
+            if ( p_enbl )
+                m_clnts.insert ( p_clnt );
+            else
+                m_clnts.remove ( p_clnt );
+        }
+
+        const QString ResultChannel::publish ( const qulonglong& p_rqst, const QString& p_clnt, const QVector<QByteArray>& p_rslts,
+                                              int* p_sz, QList<qulonglong>* p_drpd ) {
+            qint64 l_sz = 3 * sizeof ( quint32 );
+            foreach ( const QByteArray& l_rslt, p_rslts )
+                l_sz += sizeof ( quint32 ) + l_rslt.size ();
+
+            if ( l_sz > INT_MAX )
+                return QString ();
+
+            const QString l_key = QString ( "wntrling-%1-%2" ).arg ( QCoreApplication::applicationPid () ).arg ( p_rqst );
+            QSharedMemory* l_sgmnt = new QSharedMemory ( l_key );
+
+            if ( !l_sgmnt->create ( (int) l_sz ) ) {
+                lingWarning ( "ResultChannel" ) << "Couldn't form a segment for request" << p_rqst << ":" << l_sgmnt->errorString ();
+                delete l_sgmnt;
+                return QString ();
+            }
+
+            l_sgmnt->lock ();
+            char* l_dt = static_cast<char*> ( l_sgmnt->data () );
+            const quint32 l_hdr[3] = { s_mgc, s_vrsn, (quint32) p_rslts.size () };
+            memcpy ( l_dt, l_hdr, sizeof ( l_hdr ) );
+            l_dt += sizeof ( l_hdr );
+
+            foreach ( const QByteArray& l_rslt, p_rslts ) {
+                const quint32 l_rsltSz = l_rslt.size ();
+                memcpy ( l_dt, &l_rsltSz, sizeof ( l_rsltSz ) );
+                memcpy ( l_dt + sizeof ( l_rsltSz ), l_rslt.constData (), l_rsltSz );
+                l_dt += sizeof ( l_rsltSz ) + l_rsltSz;
+            }
+
+            l_sgmnt->unlock ();
+
+            QMutexLocker l_lck ( &m_lck );
+            if ( m_sgmnts.contains ( p_rqst ) ) {
+                const QString l_ownr = m_ownrs.take ( p_rqst );
+                delete m_sgmnts.take ( p_rqst );
+                m_ordr[l_ownr].removeOne ( p_rqst );
+
+                if ( m_ordr.value ( l_ownr ).isEmpty () )
+                    m_ordr.remove ( l_ownr );
+            }
+
+            QQueue<qulonglong>& l_ordr = m_ordr[p_clnt];
+            m_sgmnts.insert ( p_rqst, l_sgmnt );
+            m_ownrs.insert ( p_rqst, p_clnt );
+            l_ordr.enqueue ( p_rqst );
+
+            // Make room by dropping the segments this client never came back for.
+            while ( l_ordr.size () > m_lmt ) {
+                const qulonglong l_old = l_ordr.dequeue ();
+                delete m_sgmnts.take ( l_old );
+                m_ownrs.remove ( l_old );
+
+                if ( p_drpd )
+                    p_drpd->append ( l_old );
+            }
+
+            if ( p_sz )
+                *p_sz = (int) l_sz;
+
+            return l_key;
+        }
+
+        const bool ResultChannel::release ( const qulonglong& p_rqst, const QString& p_clnt ) {
+            QMutexLocker l_lck ( &m_lck );
+            const QHash<qulonglong, QString>::ConstIterator l_itr = m_ownrs.constFind ( p_rqst );
+
+            if ( l_itr == m_ownrs.constEnd () || l_itr.value () != p_clnt )
+                return false;
+
+            QQueue<qulonglong>& l_ordr = m_ordr[p_clnt];
+            l_ordr.removeOne ( p_rqst );
+            if ( l_ordr.isEmpty () )
+                m_ordr.remove ( p_clnt );
+
+            m_ownrs.remove ( p_rqst );
+            delete m_sgmnts.take ( p_rqst );
+            return true;
+        }
+
+        const int ResultChannel::dropClient ( const QString& p_clnt ) {
+            QMutexLocker l_lck ( &m_lck );
+            const QQueue<qulonglong> l_ordr = m_ordr.take ( p_clnt );
+            m_clnts.remove ( p_clnt );
+
+            foreach ( const qulonglong& l_rqst, l_ordr ) {
+                m_ownrs.remove ( l_rqst );
+                delete m_sgmnts.take ( l_rqst );
+            }
+
+            return l_ordr.size ();
+        }
+
+        const int ResultChannel::count() const {
+            QMutexLocker l_lck ( &m_lck );
+            return m_sgmnts.size ();
+        }
+
+        const bool ResultChannel::read ( const char* p_dt, const int& p_sz, QList<QByteArray>& p_rslts ) {
+            quint32 l_hdr[3];
+            p_rslts.clear ();
+
+            if ( p_sz < (int) sizeof ( l_hdr ) )
+                return false;
+
+            memcpy ( l_hdr, p_dt, sizeof ( l_hdr ) );
+            if ( l_hdr[0] != s_mgc || l_hdr[1] != s_vrsn )
+                return false;
+
+            int l_pos = sizeof ( l_hdr );
+            for ( quint32 l_i = 0; l_i < l_hdr[2]; l_i++ ) {
+                quint32 l_rsltSz;
+                if ( p_sz - l_pos < (int) sizeof ( l_rsltSz ) )
+                    return false;
+
+                memcpy ( &l_rsltSz, p_dt + l_pos, sizeof ( l_rsltSz ) );
+                l_pos += sizeof ( l_rsltSz );
+
+                if ( (quint32) ( p_sz - l_pos ) < l_rsltSz )
+                    return false;
+
+                p_rslts << QByteArray::fromRawData ( p_dt + l_pos, l_rsltSz );
+                l_pos += l_rsltSz;
+            }
+
+            return true;
+        }
+    }
+}
+
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
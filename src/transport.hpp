@@ -0,0 +1,151 @@
+/**
+ * @file    transport.hpp
+ * @author  Wintermute Developers <wintermute-devel@lists.launchpad.net>
+ * @date    October 19, 2026 5:10 AM
+ * @license GPL3
+ *
+ * @legalese
+ * Copyright (c) SII 2010 - 2011
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * @endlegalese
+ */
+
+#ifndef __TRANSPORT_HPP__
+#define __TRANSPORT_HPP__
+
+#include <QSet>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include <QVector>
+#include <QByteArray>
+#include <QSharedMemory>
+
+namespace Wintermute {
+    namespace Linguistics {
+        /**
+         * @brief Hands the results of a request to a local client through shared memory.
+         *
+         * Rather than copying large results through the session bus, the results of a
+         * request are written once into a shared memory segment and only its key goes
+         * over D-Bus. The segment is laid out, in the host's byte order, as:
+         *
+         * @li a quint32 magic number (0x574C5231, "WLR1") and a quint32 format version (1);
+         * @li a quint32 count of results;
+         * @li for each result, a quint32 size followed by that many bytes.
+         *
+         * read() turns such a segment into results that point straight into it. The
+         * channel keeps a segment alive until the client it was published for release()s
+         * it, or until that client has too many segments outstanding, in which case its
+         * oldest one goes. No client can release another's segment.
+         *
+         * The channel is safe to use from any thread.
+         *
+         * @class ResultChannel transport.hpp "src/transport.hpp"
+         */
+        class ResultChannel {
+            Q_DISABLE_COPY(ResultChannel)
+
+            public:
+                /**
+                 * @brief Default constructor.
+                 * @fn ResultChannel
+                 * @param p_lmt The most segments kept alive at once for each client.
+                 */
+                explicit ResultChannel ( const int& = 16 );
+
+                /**
+                 * @brief Deconstructor; drops every segment.
+                 * @fn ~ResultChannel
+                 */
+                ~ResultChannel();
+
+                /**
+                 * @brief Determines if a client wants its results through shared memory.
+                 * @fn isEnabledFor
+                 * @param p_clnt The client in question.
+                 */
+                const bool isEnabledFor ( const QString& ) const;
+
+                /**
+                 * @brief Changes whether a client wants its results through shared memory.
+                 * @fn setEnabledFor
+                 * @param p_clnt The client in question.
+                 * @param p_enbl true to use shared memory.
+                 */
+                void setEnabledFor ( const QString&, const bool& );
+
+                /**
+                 * @brief Writes the results of a request into a new segment.
+                 * @fn publish
+                 * @param p_rqst The ID of the request.
+                 * @param p_clnt The client the segment is for; only it may release() the segment.
+                 * @param p_rslts The results.
+                 * @param p_sz Set to the size of the segment, if not NULL.
+                 * @param p_drpd Filled with the requests whose segments were dropped to make room, if not NULL.
+                 * @return The key of the segment, or a null QString if it couldn't be formed.
+                 */
+                const QString publish ( const qulonglong&, const QString&, const QVector<QByteArray>&, int* = NULL, QList<qulonglong>* = NULL );
+
+                /**
+                 * @brief Drops the segment of a request.
+                 * @fn release
+                 * @param p_rqst The ID of the request.
+                 * @param p_clnt The client asking; it has to be the one the segment was published for.
+                 * @return true if the request had a segment owned by the client.
+                 */
+                const bool release ( const qulonglong&, const QString& );
+
+                /**
+                 * @brief Forgets a client: drops its segments and whether it wants shared memory.
+                 * @fn dropClient
+                 * @param p_clnt The client in question, typically one that left the bus.
+                 * @return The number of segments dropped.
+                 */
+                const int dropClient ( const QString& );
+
+                /**
+                 * @brief Obtains the number of segments kept alive.
+                 * @fn count
+                 */
+                const int count() const;
+
+                /**
+                 * @brief Reads the results out of a segment's data.
+                 *
+                 * The results don't own their bytes; they're only good while the data
+                 * stays attached.
+                 *
+                 * @fn read
+                 * @param p_dt The data of the segment.
+                 * @param p_sz The size of the data.
+                 * @param p_rslts Filled with the results.
+                 * @return false if the data isn't laid out as expected.
+                 */
+                static const bool read ( const char*, const int&, QList<QByteArray>& );
+
+            private:
+                QHash<qulonglong, QSharedMemory*> m_sgmnts;
+                QHash<qulonglong, QString> m_ownrs;
+                QHash<QString, QQueue<qulonglong> > m_ordr;
+                QSet<QString> m_clnts;
+                const int m_lmt;
+                mutable QMutex m_lck;
+        };
+    }
+}
+
+#endif /* __TRANSPORT_HPP__ */
+// kate: indent-mode cstyle; space-indent on; indent-width 4;
@@ -20,19 +20,168 @@
 
 #include "adaptors.hpp"
 #include "wntrling.hpp"
+#include "logging.hpp"
 #include <wntr/ipc.hpp>
 #include <wntr/core.hpp>
 #include <QtPlugin>
+#include <QPair>
+#include <QtAlgorithms>
+#include <QtDBus/QDBusConnection>
+#include <QtDBus/QDBusConnectionInterface>
 
 
 namespace Wintermute {
     namespace Linguistics {
+        /**
+         * @brief Parses one request on a worker thread of the System.
+         * @class ParseJob wntrling.cpp "src/wntrling.cpp"
+         */
+        class ParseJob : public ScheduledJob {
+            public:
+                ParseJob(const qulonglong& p_rqst, const QString& p_txt, const QString& p_lcl, const QSharedPointer<CancelToken>& p_tkn) :
+                    m_rqst(p_rqst), m_txt(p_txt), m_lcl(p_lcl), m_tkn(p_tkn) { }
+
+            protected:
+                virtual void execute() {
+                    System* l_sys = System::s_sys;
+                    if (!l_sys)
+                        return;
+
+                    // Called off while it was queued; don't even take a Parser.
+                    if (m_tkn->hasExpired ()) {
+                        l_sys->forget (m_rqst);
+                        l_sys->interrupt (m_rqst, *m_tkn);
+                        return;
+                    }
+
+                    Parser* l_prs = l_sys->m_prsrs.acquire (m_lcl);
+                    l_prs->setPathLimit (isDegraded () ? 1 : 0);
+                    l_prs->setResultCache (&l_sys->m_cch);
+                    l_sys->watch (l_prs, l_prs->context (), m_rqst);
+                    const Parser::Status l_sts = l_prs->parse (m_txt, m_tkn.data ());
+                    l_sys->unwatch (l_prs->context ());
+                    const QVector<QByteArray> l_rslts = l_prs->results ();
+                    l_sys->m_prsrs.release (l_prs);
+
+                    // Once its answer is out, the request can no longer be cancelled.
+                    l_sys->forget (m_rqst);
+
+                    if (l_sts == Parser::Completed || l_sts == Parser::Partial) {
+                        QString l_key;
+                        int l_sz = 0;
+
+                        QList<qulonglong> l_drpd;
+
+                        if (l_sys->m_chnl.isEnabledFor (client ()))
+                            l_key = l_sys->m_chnl.publish (m_rqst, client (), l_rslts, &l_sz, &l_drpd);
+
+                        foreach (const qulonglong& l_old, l_drpd)
+                            emit l_sys->resultDropped(l_old);
+
+                        if (!l_key.isNull ())
+                            emit l_sys->responseShared(m_rqst, l_key, l_sz);
+                        else
+                            emit l_sys->responseFormed(m_rqst, l_rslts.toList ());
+                    }
+
+                    // A deadline or cancel() landing after a complete parse doesn't make it interrupted.
+                    if (l_sts != Parser::Completed)
+                        l_sys->interrupt (m_rqst, *m_tkn);
+                }
+
+            private:
+                const qulonglong m_rqst;
+                const QString m_txt;
+                const QString m_lcl;
+                const QSharedPointer<CancelToken> m_tkn;
+        };
+
+        /**
+         * @brief Parses the texts of a batch on a worker thread of the System.
+         * @class BatchJob wntrling.cpp "src/wntrling.cpp"
+         */
+        class BatchJob : public ScheduledJob {
+            public:
+                BatchJob(const qulonglong& p_rqst, const QStringList& p_txts, const QStringList& p_lcls, const QList<int>& p_prtys,
+                         const QSharedPointer<CancelToken>& p_tkn) :
+                    m_rqst(p_rqst), m_txts(p_txts), m_lcls(p_lcls), m_prtys(p_prtys), m_tkn(p_tkn) { }
+
+            protected:
+                virtual void execute() {
+                    System* l_sys = System::s_sys;
+                    if (!l_sys)
+                        return;
+
+                    if (m_tkn->hasExpired ()) {
+                        l_sys->forget (m_rqst);
+                        l_sys->interrupt (m_rqst, *m_tkn);
+                        return;
+                    }
+
+                    // Order the texts by their priority (highest first), keeping the given order otherwise.
+                    QList<QPair<int, int> > l_ordr;
+                    for (int l_i = 0; l_i < m_txts.size (); l_i++)
+                        l_ordr << qMakePair (-m_prtys.value (l_i, 0), l_i);
+
+                    qStableSort (l_ordr.begin (), l_ordr.end ());
+
+                    QHash<QString, Parser*> l_prsrs;
+                    QList<QList<QByteArray> > l_rslts;
+                    for (int l_i = 0; l_i < m_txts.size (); l_i++)
+                        l_rslts << QList<QByteArray>();
+
+                    // Texts left over once the batch is called off keep no results.
+                    bool l_intrptd = false;
+                    int l_i = 0;
+                    for (; l_i < l_ordr.size () && !m_tkn->hasExpired (); l_i++) {
+                        const int l_indx = l_ordr.at (l_i).second;
+                        const QString l_lcl = m_lcls.value (l_indx).isEmpty () ? Data::Linguistics::System::locale () : m_lcls.at (l_indx);
+
+                        Parser*& l_prs = l_prsrs[l_lcl];
+                        if (!l_prs) {
+                            l_prs = l_sys->m_prsrs.acquire (l_lcl);
+                            l_prs->setPathLimit (isDegraded () ? 1 : 0);
+                            l_prs->setResultCache (&l_sys->m_cch);
+                        }
+
+                        l_sys->watch (l_prs, l_prs->context (), m_rqst);
+                        const Parser::Status l_sts = l_prs->parse (m_txts.at (l_indx), m_tkn.data ());
+                        l_sys->unwatch (l_prs->context ());
+                        if (l_sts == Parser::Completed || l_sts == Parser::Partial)
+                            l_rslts[l_indx] = l_prs->results ().toList ();
+
+                        l_intrptd = l_intrptd || l_sts != Parser::Completed;
+                    }
+
+                    foreach (Parser* l_prs, l_prsrs)
+                        l_sys->m_prsrs.release (l_prs);
+
+                    l_sys->forget (m_rqst);
+                    emit l_sys->batchFormed(m_rqst, l_rslts);
+
+                    if (l_intrptd || l_i < l_ordr.size ())
+                        l_sys->interrupt (m_rqst, *m_tkn);
+                }
+
+            private:
+                const qulonglong m_rqst;
+                const QStringList m_txts;
+                const QStringList m_lcls;
+                const QList<int> m_prtys;
+                const QSharedPointer<CancelToken> m_tkn;
+        };
+
         System* System::s_sys = NULL;
+        QAtomicInt System::s_rqst = 0;
 
-        System::System() : QObject(), m_prs((new Parser)) {
+        System::System() : QObject(), m_schd(), m_prsrs(), m_cch(), m_chnl(), m_clntWtchr(), m_tkns(), m_tknLck() {
             if (System::s_sys)
                 System::s_sys->deleteLater ();
 
+            m_clntWtchr.setConnection (QDBusConnection::sessionBus ());
+            m_clntWtchr.setWatchMode (QDBusServiceWatcher::WatchForUnregistration);
+            connect(&m_clntWtchr,SIGNAL(serviceUnregistered(QString)),this,SLOT(dropClient(QString)));
+
             connect(this,SIGNAL(started()),Data::System::instance(),SLOT(start()));
             connect(this,SIGNAL(stopped()),Data::System::instance(),SLOT(stop()));
 
@@ -40,7 +189,12 @@ namespace Wintermute {
 
         }
 
-        System::~System () { m_prs->deleteLater (); }
+        System::~System () {
+            m_schd.waitForDone ();
+
+            if (System::s_sys == this)
+                System::s_sys = NULL;
+        }
 
         System* System::instance () {
             if (!System::s_sys)
@@ -55,9 +209,161 @@ namespace Wintermute {
 
         void System::stop () { emit s_sys->stopped (); }
 
-        void System::tellSystem (const QString &p_txt){
-            s_sys->m_prs->parse (p_txt);
-            emit s_sys->responseFormed(p_txt);
+        const int System::workerCount () {
+            return instance ()->m_schd.workerCount ();
+        }
+
+        void System::setWorkerCount (const int& p_cnt) {
+            instance ()->m_schd.setWorkerCount (p_cnt);
+        }
+
+        Scheduler* System::scheduler () {
+            return &instance ()->m_schd;
+        }
+
+        ResultCache* System::resultCache () {
+            return &instance ()->m_cch;
+        }
+
+        void System::invalidateResults () {
+            // Bump the lexicon revision first, so results of parses still running are stale too.
+            Node::clearExpansions ();
+            Rule::clearCache ();
+            instance ()->m_cch.invalidate ();
+        }
+
+        void System::setSharedResults (const QString& p_clnt, const bool& p_enbl) {
+            System* l_sys = instance ();
+            l_sys->m_chnl.setEnabledFor (p_clnt, p_enbl);
+
+            // Only bus clients can vanish without a word; watch them so their segments don't outlive them.
+            if (!p_enbl || !p_clnt.startsWith (':'))
+                return;
+
+            l_sys->m_clntWtchr.addWatchedService (p_clnt);
+
+            // It may have left before the watch was set up.
+            QDBusConnectionInterface* l_bus = QDBusConnection::sessionBus ().interface ();
+            if (l_bus && !l_bus->isServiceRegistered (p_clnt).value ())
+                l_sys->dropClient (p_clnt);
+        }
+
+        void System::dropClient (const QString& p_clnt) {
+            m_clntWtchr.removeWatchedService (p_clnt);
+            const int l_cnt = m_chnl.dropClient (p_clnt);
+
+            if (l_cnt > 0)
+                lingDebug ( "System" ) << "Dropped" << l_cnt << "shared result(s) of" << p_clnt << ", which left the bus.";
+        }
+
+        const bool System::releaseResult (const qulonglong& p_rqst, const QString& p_clnt) {
+            return instance ()->m_chnl.release (p_rqst, p_clnt);
+        }
+
+        const qulonglong System::nextRequest () {
+            // The counter wraps around; skip the 0 that tells a caller its request was rejected.
+            quint32 l_rqst = 0;
+            while (l_rqst == 0)
+                l_rqst = static_cast<quint32> (s_rqst.fetchAndAddOrdered (1)) + 1u;
+
+            return l_rqst;
+        }
+
+        const qulonglong System::tellSystem (const QString &p_txt, const QString& p_lcl, const int& p_prty, const int& p_ddln,
+                                             const QString& p_clnt, Scheduler::Decision* p_dcsn){
+            System* l_sys = instance ();
+            const qulonglong l_rqst = nextRequest ();
+            const QString l_lcl = p_lcl.isEmpty () ? Data::Linguistics::System::locale () : p_lcl;
+            const Scheduler::Priority l_prty = (Scheduler::Priority) qBound ((int) Scheduler::Batch, p_prty, (int) Scheduler::Interactive);
+            const QSharedPointer<CancelToken> l_tkn = l_sys->track (l_rqst, p_clnt, p_ddln);
+            const Scheduler::Decision l_dcsn = l_sys->m_schd.submit (new ParseJob (l_rqst, p_txt, l_lcl, l_tkn), p_clnt, l_prty);
+
+            if (p_dcsn)
+                *p_dcsn = l_dcsn;
+
+            if (l_dcsn == Scheduler::Admitted || l_dcsn == Scheduler::Degraded)
+                return l_rqst;
+
+            l_sys->forget (l_rqst);
+            return 0;
+        }
+
+        const qulonglong System::tellSystemBatch (const QStringList &p_txts, const QStringList& p_lcls, const QList<int>& p_prtys,
+                                                  const QString& p_clnt, Scheduler::Decision* p_dcsn){
+            System* l_sys = instance ();
+            const qulonglong l_rqst = nextRequest ();
+            const QSharedPointer<CancelToken> l_tkn = l_sys->track (l_rqst, p_clnt, 0);
+            const Scheduler::Decision l_dcsn = l_sys->m_schd.submit (new BatchJob (l_rqst, p_txts, p_lcls, p_prtys, l_tkn), p_clnt, Scheduler::Batch);
+
+            if (p_dcsn)
+                *p_dcsn = l_dcsn;
+
+            if (l_dcsn == Scheduler::Admitted || l_dcsn == Scheduler::Degraded)
+                return l_rqst;
+
+            l_sys->forget (l_rqst);
+            return 0;
+        }
+
+        const bool System::cancel (const qulonglong& p_rqst, const QString& p_clnt) {
+            System* l_sys = instance ();
+            QMutexLocker l_lck (&l_sys->m_tknLck);
+            const QPair<QString, QSharedPointer<CancelToken> > l_ntry = l_sys->m_tkns.value (p_rqst);
+
+            if (l_ntry.second.isNull () || (!p_clnt.isEmpty () && l_ntry.first != p_clnt))
+                return false;
+
+            l_ntry.second->cancel ();
+            return true;
+        }
+
+        QSharedPointer<CancelToken> System::track (const qulonglong& p_rqst, const QString& p_clnt, const int& p_ddln) {
+            const QSharedPointer<CancelToken> l_tkn (new CancelToken (p_ddln));
+            QMutexLocker l_lck (&m_tknLck);
+            m_tkns.insert (p_rqst, qMakePair (p_clnt, l_tkn));
+            return l_tkn;
+        }
+
+        void System::forget (const qulonglong& p_rqst) {
+            QMutexLocker l_lck (&m_tknLck);
+            m_tkns.remove (p_rqst);
+        }
+
+        void System::watch (Parser* p_prs, const ParseContext* p_ctx, const qulonglong& p_rqst) {
+            // Emitted from the worker's thread; relay it there rather than queue it behind the event loop.
+            connect (p_prs, SIGNAL(progressed(const ParseContext*,double,double,qint64)),
+                     this, SLOT(relayProgress(const ParseContext*,double,double,qint64)),
+                     static_cast<Qt::ConnectionType> (Qt::DirectConnection | Qt::UniqueConnection));
+
+            QMutexLocker l_lck (&m_tknLck);
+            m_prgrs.insert (p_ctx, p_rqst);
+        }
+
+        void System::unwatch (const ParseContext* p_ctx) {
+            QMutexLocker l_lck (&m_tknLck);
+            m_prgrs.remove (p_ctx);
+        }
+
+        void System::relayProgress (const ParseContext* p_ctx, const double& p_frctn, const double& p_rt, const qint64& p_eta) {
+            m_tknLck.lock ();
+            const QHash<const ParseContext*, qulonglong>::ConstIterator l_itr = m_prgrs.constFind (p_ctx);
+            const bool l_fnd = l_itr != m_prgrs.constEnd ();
+            const qulonglong l_rqst = l_fnd ? l_itr.value () : 0;
+            m_tknLck.unlock ();
+
+            if (l_fnd)
+                emit parseProgressed (l_rqst, p_frctn, p_rt, p_eta);
+        }
+
+        const bool System::interrupt (const qulonglong& p_rqst, const CancelToken& p_tkn) {
+            if (p_tkn.isCancelled ())
+                emit requestInterrupted (p_rqst, "cancelled");
+            else if (p_tkn.isTimedOut ())
+                emit requestInterrupted (p_rqst, "timedOut");
+            else
+                return false;
+
+            return true;
         }
 
         void Plugin::start () const {
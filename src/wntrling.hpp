@@ -38,7 +38,16 @@
 #include "parser.hpp"
 #include "meanings.hpp"
 #include "adaptors.hpp"
+#include "pool.hpp"
+#include "scheduler.hpp"
+#include "cancel.hpp"
+#include "transport.hpp"
 #include <QObject>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QThread>
+#include <QtDBus/QDBusServiceWatcher>
 #include <wntr/plugins.hpp>
 
 using Wintermute::Plugins::AbstractPlugin;
@@ -47,21 +56,43 @@ namespace Wintermute {
     namespace Linguistics {
         struct System;
         struct Plugin;
+        class ParseJob;
+        class BatchJob;
 
         /**
          * @brief Represents a maintence class for Wintermute's linguistics.
          * The System object (as commonly used throughout Wintermute) handles the
          * nitty-gritty work of starting up, cleaning up and shutting down the objects
          * required for optimal natural language intepretative peformance to occur.
+         *
+         * Text handed to tellSystem() goes through a Scheduler, which admits it (perhaps
+         * in a cheaper parsing mode) or turns it away, and is then parsed on one of its
+         * worker threads with a Parser of the request's locale taken from a ParserPool.
+         * The caller gets a request ID straight away and the outcome is announced by
+         * responseFormed() with that same ID. A request may be given a deadline and can
+         * be called off with cancel(); either way requestInterrupted() reports it, and
+         * a request called off before a worker picked it up is never parsed at all.
+         * Local clients may take large results through a ResultChannel instead.
          * @class System wntrling.hpp "src/wntrling.hpp"
          */
         class System : public QObject {
             Q_OBJECT
             Q_DISABLE_COPY(System)
+            friend class ParseJob;
+            friend class BatchJob;
 
             private:
                 static System* s_sys; /**< The internal instance. */
-                Parser* m_prs; /**< The global parser instance. */
+                static QAtomicInt s_rqst; /**< The last request ID handed out. */
+                static const qulonglong nextRequest(); /**< Hands out a request ID; never 0, which marks a rejection. */
+                Scheduler m_schd; /**< Admits requests and runs the parses. */
+                ParserPool m_prsrs; /**< The idle parsers of each locale. */
+                ResultCache m_cch; /**< The results of sentences parsed before. */
+                ResultChannel m_chnl; /**< The shared memory segments holding results for local clients. */
+                QDBusServiceWatcher m_clntWtchr; /**< Watches the clients of m_chnl leave the bus. */
+                QHash<qulonglong, QPair<QString, QSharedPointer<CancelToken> > > m_tkns; /**< The client and CancelToken of each pending request. */
+                QHash<const ParseContext*, qulonglong> m_prgrs; /**< The request each busy ParseContext is parsing. */
+                QMutex m_tknLck; /**< Guards m_tkns and m_prgrs. */
                 /**
                  * @brief Destructor.
                  * @fn System
@@ -69,6 +100,57 @@ namespace Wintermute {
                 System();
                 ~System();
 
+                /**
+                 * @brief Forms and remembers the CancelToken of a request.
+                 * @fn track
+                 * @param p_rqst The ID of the request.
+                 * @param p_clnt The client making the request.
+                 * @param p_ddln The deadline of the request in milliseconds, or 0 for none.
+                 */
+                QSharedPointer<CancelToken> track(const qulonglong&, const QString&, const int&);
+
+                /**
+                 * @brief Forgets the CancelToken of a request that's done with.
+                 * @fn forget
+                 * @param p_rqst The ID of the request.
+                 */
+                void forget(const qulonglong&);
+
+                /**
+                 * @brief Announces that a request was called off, if it was.
+                 * @fn interrupt
+                 * @param p_rqst The ID of the request.
+                 * @param p_tkn The CancelToken of the request.
+                 * @return true if the request was called off.
+                 */
+                const bool interrupt(const qulonglong&, const CancelToken&);
+
+                /**
+                 * @brief Relays the progress of a parse as that of a request until unwatch() is called.
+                 * @fn watch
+                 * @param p_prs The Parser.
+                 * @param p_ctx The ParseContext the parse runs in.
+                 * @param p_rqst The ID of the request it's parsing.
+                 */
+                void watch(Parser*, const ParseContext*, const qulonglong&);
+
+                /**
+                 * @brief Stops relaying the progress of a parse.
+                 * @fn unwatch
+                 * @param p_ctx The ParseContext the parse ran in.
+                 */
+                void unwatch(const ParseContext*);
+
+            private slots:
+                void relayProgress(const ParseContext*, const double&, const double&, const qint64&);
+
+                /**
+                 * @brief Drops the shared results of a client that left the bus.
+                 * @fn dropClient
+                 * @param p_clnt The unique bus name of the client.
+                 */
+                void dropClient(const QString&);
+
             signals:
                 /**
                  * @brief Emitted when the System is online.
@@ -85,9 +167,64 @@ namespace Wintermute {
                 /**
                  * @brief Emitted when a response is generated.
                  * @fn responseFormed
-                 * @param p_rpsn The response formed by Wintermute.
+                 * @param p_rqst The ID of the request, as returned by tellSystem().
+                 * @param p_rslts The result of each sentence of the text, as laid out by MeaningEncoding;
+                 *                a sentence that formed no meaning has an empty result.
+                 */
+                void responseFormed(const qulonglong&, const QList<QByteArray>&);
+
+                /**
+                 * @brief Emitted when every text of a batch has been parsed.
+                 * @fn batchFormed
+                 * @param p_rqst The ID of the batch, as returned by tellSystemBatch().
+                 * @param p_rslts The results of each text, in the order the texts were given, as
+                 *                responseFormed() gives them; a text that wasn't parsed has none.
+                 */
+                void batchFormed(const qulonglong&, const QList<QList<QByteArray> >&);
+
+                /**
+                 * @brief Emitted instead of responseFormed() for a client that takes its results through shared memory.
+                 * @fn responseShared
+                 * @param p_rqst The ID of the request, as returned by tellSystem().
+                 * @param p_key The key of the QSharedMemory segment holding the results; see ResultChannel.
+                 * @param p_sz The size of the segment.
+                 */
+                void responseShared(const qulonglong&, const QString&, const int&);
+
+                /**
+                 * @brief Emitted when the segment of a request is dropped before its client released it.
+                 *
+                 * A client that lets too many segments pile up loses its oldest ones; the key
+                 * handed out by responseShared() for such a request no longer exists.
+                 *
+                 * @fn resultDropped
+                 * @param p_rqst The ID of the request.
+                 */
+                void resultDropped(const qulonglong&);
+
+                /**
+                 * @brief Emitted when a request was called off before it was fully parsed.
+                 *
+                 * Whatever was parsed by then is still reported by responseFormed() or
+                 * batchFormed(); a request called off before any text was parsed gets no
+                 * other signal.
+                 *
+                 * @fn requestInterrupted
+                 * @param p_rqst The ID of the request.
+                 * @param p_rsn Either "cancelled" or "timedOut".
+                 */
+                void requestInterrupted(const qulonglong&, const QString&);
+
+                /**
+                 * @brief Emitted every so often while a request is parsed, at most once per 50 ms.
+                 * @fn parseProgressed
+                 * @param p_rqst The ID of the request.
+                 * @param p_frctn The fraction of the text parsed, from 0.0 to 1.0.
+                 * @param p_rt The paths tried per second in the sentence being parsed.
+                 * @param p_eta The estimated time left for that sentence in milliseconds, or -1 if unknown.
+                 * @see Parser::progressed()
                  */
-                void responseFormed(const QString&);
+                void parseProgressed(const qulonglong&, const double&, const double&, const qlonglong&);
 
             public:
                 /**
@@ -97,6 +234,31 @@ namespace Wintermute {
                  */
                 static System* instance();
 
+                /**
+                 * @brief Obtains the number of threads parsing requests.
+                 * @fn workerCount
+                 */
+                static const int workerCount();
+
+                /**
+                 * @brief Changes the number of threads parsing requests.
+                 * @fn setWorkerCount
+                 * @param p_cnt The number of threads; defaults to the number of cores.
+                 */
+                static void setWorkerCount(const int& = QThread::idealThreadCount ());
+
+                /**
+                 * @brief Obtains the Scheduler admitting requests.
+                 * @fn scheduler
+                 */
+                static Scheduler* scheduler();
+
+                /**
+                 * @brief Obtains the ResultCache shared by every parse.
+                 * @fn resultCache
+                 */
+                static ResultCache* resultCache();
+
             public slots:
                 /**
                  * @brief
@@ -113,12 +275,82 @@ namespace Wintermute {
                 static void stop();
 
                 /**
-                 * @brief
-                 *
+                 * @brief Queues text to be parsed.
                  * @fn tellSystem
-                 * @param
+                 * @param p_txt The text to be parsed.
+                 * @param p_lcl The locale of the text, or an empty QString for Wintermute's default locale.
+                 * @param p_prty The Scheduler::Priority of the request.
+                 * @param p_ddln The number of milliseconds the request has to be parsed in, counted from now; 0 for no deadline.
+                 * @param p_clnt The client making the request.
+                 * @param p_dcsn If not NULL, set to the decision made by the Scheduler.
+                 * @return The ID of the request, repeated by responseFormed() once it's parsed, or 0 if it was rejected.
                  */
-                static void tellSystem(const QString& );
+                static const qulonglong tellSystem(const QString&, const QString& = QString(),
+                                                   const int& = Scheduler::Normal, const int& = 0,
+                                                   const QString& = QString(), Scheduler::Decision* = NULL );
+
+                /**
+                 * @brief Queues many texts to be parsed as one request.
+                 *
+                 * The texts are parsed by a single worker, the most urgent first, and every
+                 * text of a locale is parsed by the same Parser; lookups formed for one text
+                 * are still warm for the next. One batchFormed() reports the whole batch.
+                 * The batch as a whole is scheduled as a Scheduler::Batch request.
+                 *
+                 * @fn tellSystemBatch
+                 * @param p_txts The texts to be parsed.
+                 * @param p_lcls The locale of each text; missing or empty entries use Wintermute's default locale.
+                 * @param p_prtys The priority of each text, the highest parsed first; missing entries count as 0.
+                 * @param p_clnt The client making the request.
+                 * @param p_dcsn If not NULL, set to the decision made by the Scheduler.
+                 * @return The ID of the batch, repeated by batchFormed() once it's parsed, or 0 if it was rejected.
+                 */
+                static const qulonglong tellSystemBatch(const QStringList&, const QStringList& = QStringList(),
+                                                        const QList<int>& = QList<int>(), const QString& = QString(),
+                                                        Scheduler::Decision* = NULL );
+
+                /**
+                 * @brief Calls off a request made with tellSystem() or tellSystemBatch().
+                 * @fn cancel
+                 * @param p_rqst The ID of the request.
+                 * @param p_clnt The client calling it off; if not empty, it has to be the client that made the request.
+                 * @return true if the request was still pending and is now called off.
+                 */
+                static const bool cancel(const qulonglong&, const QString& = QString());
+
+                /**
+                 * @brief Forgets the results of every sentence parsed so far, along with the shared Rule objects and Node variants.
+                 *
+                 * Results go stale by themselves when the lexicon changes through this
+                 * process; this has to be called when the rules change, or when the
+                 * lexicon is changed by anyone else.
+                 *
+                 * @fn invalidateResults
+                 */
+                static void invalidateResults();
+
+                /**
+                 * @brief Changes whether a client takes the results of its requests through shared memory.
+                 *
+                 * Such a client gets responseShared() rather than responseFormed() for each
+                 * request made with tellSystem(), and has to releaseResult() once it has
+                 * read the segment. Batches are still answered by batchFormed(). A bus
+                 * client's segments are dropped when it leaves the bus.
+                 *
+                 * @fn setSharedResults
+                 * @param p_clnt The client.
+                 * @param p_enbl true to use shared memory.
+                 */
+                static void setSharedResults(const QString&, const bool&);
+
+                /**
+                 * @brief Drops the shared memory segment holding the results of a request.
+                 * @fn releaseResult
+                 * @param p_rqst The ID of the request.
+                 * @param p_clnt The client asking; only the client the results were shared with may drop them.
+                 * @return true if the request had a segment owned by the client.
+                 */
+                static const bool releaseResult(const qulonglong&, const QString&);
         };
 
         class Plugin : public AbstractPlugin {
@@ -135,5 +367,8 @@ namespace Wintermute {
     }
 }
 
+Q_DECLARE_METATYPE(QList<QByteArray>)
+Q_DECLARE_METATYPE(QList<QList<QByteArray> >)
+
 #endif /* WINTERMUTE_LINGUISTICS */
 // kate: indent-mode cstyle; space-indent on; indent-width 4;